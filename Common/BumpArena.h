@@ -0,0 +1,92 @@
+#pragma once
+#ifndef __COMMON_BUMP_ARENA_H__
+#define __COMMON_BUMP_ARENA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include "AllocatorHelper.h"
+
+// single-threaded bump allocator. memory is handed out from a chain of blocks and is only
+// reclaimed all at once by Reset(), which rewinds to the first block in O(1) and keeps the
+// blocks for reuse. destructors of objects placed in the arena are never run.
+class BumpArena{
+public:
+	BumpArena(const size_t &block_size = kDefaultBlockSize) : block_size_(block_size), head_(NULL), curr_block_(NULL), curr_ptr_(NULL), curr_end_(NULL){}
+
+	~BumpArena(){
+		while (head_ != NULL){
+			Block *next = head_->next_;
+			MemAllocator::Free((char*)head_);
+			head_ = next;
+		}
+	}
+
+	char* Alloc(const size_t &size){
+		size_t aligned_size = (size + kAlignment - 1) & ~(kAlignment - 1);
+		if (curr_ptr_ + aligned_size > curr_end_){
+			NextBlock(aligned_size);
+		}
+		char *ret = curr_ptr_;
+		curr_ptr_ += aligned_size;
+		return ret;
+	}
+
+	void Reset(){
+		curr_block_ = head_;
+		if (head_ != NULL){
+			curr_ptr_ = head_->GetData();
+			curr_end_ = curr_ptr_ + head_->size_;
+		}
+		else{
+			curr_ptr_ = NULL;
+			curr_end_ = NULL;
+		}
+	}
+
+private:
+	BumpArena(const BumpArena&);
+	BumpArena& operator=(const BumpArena&);
+
+	struct Block{
+		Block *next_;
+		size_t size_;
+
+		char* GetData(){
+			return (char*)this + kHeaderSize;
+		}
+	};
+
+	// move on to the next block that can hold size bytes, allocating it if needed.
+	void NextBlock(const size_t &size){
+		Block *next = (curr_block_ == NULL) ? head_ : curr_block_->next_;
+		if (next == NULL || next->size_ < size){
+			size_t block_size = size > block_size_ ? size : block_size_;
+			Block *block = (Block*)MemAllocator::Alloc(kHeaderSize + block_size);
+			block->size_ = block_size;
+			block->next_ = next;
+			if (curr_block_ == NULL){
+				head_ = block;
+			}
+			else{
+				curr_block_->next_ = block;
+			}
+			next = block;
+		}
+		curr_block_ = next;
+		curr_ptr_ = next->GetData();
+		curr_end_ = curr_ptr_ + next->size_;
+	}
+
+private:
+	static const size_t kDefaultBlockSize = 1 << 20;
+	static const size_t kAlignment = 16;
+	static const size_t kHeaderSize = (sizeof(Block) + kAlignment - 1) & ~(kAlignment - 1);
+
+	const size_t block_size_;
+	Block *head_;
+	Block *curr_block_;
+	char *curr_ptr_;
+	char *curr_end_;
+};
+
+#endif
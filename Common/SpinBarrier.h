@@ -0,0 +1,34 @@
+#pragma once
+#ifndef __COMMON_SPIN_BARRIER_H__
+#define __COMMON_SPIN_BARRIER_H__
+
+#include <atomic>
+#include <cstddef>
+
+// reusable barrier for a fixed group of threads. threads spin until the last one arrives.
+class SpinBarrier{
+public:
+	SpinBarrier(const size_t &thread_count) : thread_count_(thread_count), arrived_count_(0), generation_(0){}
+
+	void Wait(){
+		size_t generation = generation_.load();
+		if (arrived_count_.fetch_add(1) + 1 == thread_count_){
+			arrived_count_.store(0);
+			generation_.fetch_add(1);
+		}
+		else{
+			while (generation_.load() == generation);
+		}
+	}
+
+private:
+	SpinBarrier(const SpinBarrier&);
+	SpinBarrier& operator=(const SpinBarrier&);
+
+private:
+	const size_t thread_count_;
+	std::atomic<size_t> arrived_count_;
+	std::atomic<size_t> generation_;
+};
+
+#endif
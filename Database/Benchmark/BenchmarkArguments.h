@@ -48,6 +48,9 @@ static void PrintUsage() {
 	std::cout << "\t-tINT: TXN_COUNT" << std::endl;
 	std::cout << "\t-dINT: DIST_TXN_RATIO" << std::endl;
 	std::cout << "\t-zINT: BATCH_SIZE" << std::endl;
+	std::cout << "\t-jINT: PARTITION_THREAD_COUNT" << std::endl;
+	std::cout << "\t-gINT: PARTITIONER_TYPE (0: GREEDY [DEFAULT], 1: MULTILEVEL)" << std::endl;
+	std::cout << "\t-eINT: RETRY_POLICY (0: SPIN [DEFAULT], 1: BATCH_END, 2: DEADLINE, 3: SERIAL_LANE)" << std::endl;
 	std::cout << "\t-cINT: CORE_COUNT" << std::endl;
 	std::cout << "\t-nINT: NODE_COUNT" << std::endl;
 	std::cout << "\t-rINT: REPLAY_TYPE (0: COMMAND [DEFAULT])" << std::endl;
@@ -73,6 +76,14 @@ static void ArgumentsChecker() {
 		std::cout << "REPLAY_TYPE (-r) should be in [0-" << kAppReplaySize << "]." << std::endl;
 		exit(0);
 	}
+	if (Cavalia::Database::gPartitionerType >= Cavalia::Database::kPartitionerTypeSize) {
+		std::cout << "PARTITIONER_TYPE (-g) should be in [0-" << Cavalia::Database::kPartitionerTypeSize - 1 << "]." << std::endl;
+		exit(0);
+	}
+	if (Cavalia::Database::gRetryPolicy >= Cavalia::Database::kRetryPolicyTypeSize) {
+		std::cout << "RETRY_POLICY (-e) should be in [0-" << Cavalia::Database::kRetryPolicyTypeSize - 1 << "]." << std::endl;
+		exit(0);
+	}
 	else if (app_type == APP_POPULATE) {
 		if (factor_count == 0) {
 			std::cout << "SCALE_FACTOR (-sf) should be set." << std::endl;
@@ -174,6 +185,15 @@ static void ArgumentsParser(int argc, char *argv[]) {
 		else if (argv[i][1] == 'z') {
 			Cavalia::Database::gParamBatchSize = atoi(&argv[i][2]);
 		}
+		else if (argv[i][1] == 'j') {
+			Cavalia::Database::gPartitionThreadCount = atoi(&argv[i][2]);
+		}
+		else if (argv[i][1] == 'g') {
+			Cavalia::Database::gPartitionerType = atoi(&argv[i][2]);
+		}
+		else if (argv[i][1] == 'e') {
+			Cavalia::Database::gRetryPolicy = atoi(&argv[i][2]);
+		}
 		else if (argv[i][1] == 'o') {
 			Cavalia::Database::gAdhocRatio = atoi(&argv[i][2]);
 		}
@@ -48,6 +48,11 @@ namespace Cavalia {
 				return timestamp_.load(std::memory_order_relaxed);
 			}
 
+			uint64_t GetTimestamp(bool &is_locked) const {
+				is_locked = lock_.ExistsWriteLock();
+				return timestamp_.load(std::memory_order_relaxed);
+			}
+
 		private:
 			std::atomic<uint64_t> timestamp_;
 			RWLock lock_;
@@ -57,8 +57,9 @@ namespace Cavalia{
 				spinlock_.ReleaseReadLock();
 			}
 
-			// precondition: write lock acquired already
-			void WriteAccess(const uint64_t &commit_timestamp, char* data_ptr){
+			// precondition: write lock acquired already.
+			// returns the versions no snapshot can see any more, which the caller hands to GarbageCollector.
+			MvHistoryEntry* WriteAccess(const uint64_t &commit_timestamp, char* data_ptr){
 				spinlock_.AcquireWriteLock();
 				assert(commit_timestamp > timestamp_);
 				timestamp_ = commit_timestamp;
@@ -76,8 +77,14 @@ namespace Cavalia{
 					history_tail_ = entry;
 				}
 				++history_length_;
-				//CollectGarbage();
+				MvHistoryEntry *garbage = CollectGarbage();
 				spinlock_.ReleaseWriteLock();
+				return garbage;
+			}
+
+			// read without the latch, for statistics only.
+			size_t GetHistoryLength() const {
+				return history_length_;
 			}
 
 			void AcquireReadLock(){
@@ -105,26 +112,29 @@ namespace Cavalia{
 			}
 
 		private:
-			void CollectGarbage(){
+			MvHistoryEntry* CollectGarbage(){
 				if (history_length_ > kRecycleLength){
 					uint64_t min_thread_ts = GlobalTimestamp::GetMinTimestamp();
-					ClearHistory(min_thread_ts);
+					return DetachHistory(min_thread_ts);
 				}
+				return NULL;
 			}
 
-			void ClearHistory(const uint64_t &timestamp) {
+			// unlinks the versions older than the newest one below timestamp, which is still visible at timestamp.
+			MvHistoryEntry* DetachHistory(const uint64_t &timestamp) {
 				MvHistoryEntry* his_entry = history_tail_;
 				while (his_entry != NULL && his_entry->prev_ != NULL && his_entry->prev_->timestamp_ < timestamp) {
-					MvHistoryEntry* tmp_entry = his_entry;
 					his_entry = his_entry->prev_;
-					delete tmp_entry;
-					tmp_entry = NULL;
 					--history_length_;
 				}
-				history_tail_ = his_entry;
-				if (history_tail_ != NULL){
-					history_tail_->next_ = NULL;
+				if (his_entry == history_tail_){
+					return NULL;
 				}
+				MvHistoryEntry* garbage = his_entry->next_;
+				garbage->prev_ = NULL;
+				his_entry->next_ = NULL;
+				history_tail_ = his_entry;
+				return garbage;
 			}
 
 		private:
@@ -96,16 +96,22 @@ namespace Cavalia {
 				return is_success;
 			}
 
-			void RequestCommit(const uint64_t &timestamp, char* data_ptr){
+			// returns the versions no snapshot can see any more, which the caller hands to GarbageCollector.
+			MvHistoryEntry* RequestCommit(const uint64_t &timestamp, char* data_ptr){
 				spinlock_.lock();
 				MvRequestEntry* entry = DebufferWriteRequest(timestamp);
 				InsertWriteHistory(timestamp, data_ptr);
 				UpdateBuffer();
 				delete entry;
 				entry = NULL;
-				// clear garbage here.
-				//CollectGarbage();
+				MvHistoryEntry *garbage = CollectGarbage();
 				spinlock_.unlock();
+				return garbage;
+			}
+
+			// read without the latch, for statistics only.
+			size_t GetHistoryLength() const {
+				return write_history_length_;
 			}
 
 			void RequestAbort(const uint64_t &timestamp) {
@@ -356,6 +362,12 @@ namespace Cavalia {
 					}
 					his->prev_ = new_entry;
 				}
+				else if (read_history_tail_ != NULL) {
+					// older than every entry, appended at the tail.
+					new_entry->prev_ = read_history_tail_;
+					read_history_tail_->next_ = new_entry;
+					read_history_tail_ = new_entry;
+				}
 				else {
 					read_history_head_ = read_history_tail_ = new_entry;
 				}
@@ -382,22 +394,30 @@ namespace Cavalia {
 					}
 					his->prev_ = new_entry;
 				}
+				else if (write_history_tail_ != NULL) {
+					// older than every entry, appended at the tail.
+					new_entry->prev_ = write_history_tail_;
+					write_history_tail_->next_ = new_entry;
+					write_history_tail_ = new_entry;
+				}
 				else {
 					write_history_head_ = write_history_tail_ = new_entry;
 				}
 			}
 
-			void CollectGarbage(){
+			MvHistoryEntry* CollectGarbage(){
 				if (read_history_length_ > kRecycleLength * 1000){
 					uint64_t min_thread_ts = GlobalTimestamp::GetMinTimestamp();
 					ClearReadHistory(min_thread_ts);
 				}
 				if (write_history_length_ > kRecycleLength){
 					uint64_t min_thread_ts = GlobalTimestamp::GetMinTimestamp();
-					ClearWriteHistory(min_thread_ts);
+					return DetachWriteHistory(min_thread_ts);
 				}
+				return NULL;
 			}
 
+			// read history only holds timestamps and is never reached without the latch, so it is deleted right away.
 			void ClearReadHistory(const uint64_t &timestamp) {
 				MvHistoryEntry* his_entry = read_history_tail_;
 				while (his_entry != NULL && his_entry->timestamp_ < timestamp) {
@@ -416,19 +436,21 @@ namespace Cavalia {
 				}
 			}
 
-			void ClearWriteHistory(const uint64_t &timestamp) {
+			// unlinks the versions older than the newest one below timestamp, which is still visible at timestamp.
+			MvHistoryEntry* DetachWriteHistory(const uint64_t &timestamp) {
 				MvHistoryEntry* his_entry = write_history_tail_;
 				while (his_entry != NULL && his_entry->prev_ != NULL && his_entry->prev_->timestamp_ < timestamp) {
-					MvHistoryEntry* tmp_entry = his_entry;
 					his_entry = his_entry->prev_;
-					delete tmp_entry;
-					tmp_entry = NULL;
 					--write_history_length_;
 				}
-				write_history_tail_ = his_entry;
-				if (write_history_tail_ != NULL){
-					write_history_tail_->next_ = NULL;
+				if (his_entry == write_history_tail_){
+					return NULL;
 				}
+				MvHistoryEntry* garbage = his_entry->next_;
+				garbage->prev_ = NULL;
+				his_entry->next_ = NULL;
+				write_history_tail_ = his_entry;
+				return garbage;
 			}
 
 		private:
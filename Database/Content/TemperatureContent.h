@@ -0,0 +1,45 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_TEMPERATURE_CONTENT_H__
+#define __CAVALIA_DATABASE_TEMPERATURE_CONTENT_H__
+
+#include <atomic>
+#include <cstdint>
+
+namespace Cavalia {
+	namespace Database {
+		// how often validations of a record failed lately, used by -DMIXED_CC to lock hot records early.
+		class TemperatureContent {
+		public:
+			TemperatureContent() : temperature_(0) {}
+
+			bool IsHot() const {
+				return temperature_.load(std::memory_order_relaxed) >= kHotTemperature;
+			}
+
+			// a transaction failed validation on this record.
+			void Heat() {
+				uint32_t temperature = temperature_.load(std::memory_order_relaxed);
+				if (temperature < kMaxTemperature) {
+					temperature_.fetch_add(kHeatStep, std::memory_order_relaxed);
+				}
+			}
+
+			// a transaction went through this record without conflict.
+			void Cool() {
+				uint32_t temperature = temperature_.load(std::memory_order_relaxed);
+				if (temperature > 0) {
+					temperature_.store(temperature - 1, std::memory_order_relaxed);
+				}
+			}
+
+		private:
+			static const uint32_t kHotTemperature = 8;
+			static const uint32_t kHeatStep = 4;
+			static const uint32_t kMaxTemperature = 64;
+
+			std::atomic<uint32_t> temperature_;
+		};
+	}
+}
+
+#endif
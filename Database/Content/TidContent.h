@@ -0,0 +1,76 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_TID_CONTENT_H__
+#define __CAVALIA_DATABASE_TID_CONTENT_H__
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace Cavalia {
+	namespace Database {
+		/*
+		** Class TidContent:
+		** -----------------
+		** Silo's TID word: the write lock is the top bit of the word that holds the timestamp, so a reader
+		** validates a record with a single load and never writes to its cache line. There is no read lock.
+		*/
+		class TidContent {
+		public:
+			TidContent() : tid_word_(0) {}
+
+			bool TryWriteLock() {
+				uint64_t tid_word = tid_word_.load(std::memory_order_relaxed);
+				if ((tid_word & kLockBit) != 0) {
+					return false;
+				}
+				return tid_word_.compare_exchange_strong(tid_word, tid_word | kLockBit, std::memory_order_acquire);
+			}
+
+			void AcquireWriteLock() {
+				while (true) {
+					uint64_t tid_word = tid_word_.load(std::memory_order_relaxed);
+					if ((tid_word & kLockBit) == 0 && tid_word_.compare_exchange_weak(tid_word, tid_word | kLockBit, std::memory_order_acquire)) {
+						return;
+					}
+				}
+			}
+
+			void ReleaseWriteLock() {
+				uint64_t tid_word = tid_word_.load(std::memory_order_relaxed);
+				assert((tid_word & kLockBit) != 0);
+				tid_word_.store(tid_word & ~kLockBit, std::memory_order_release);
+			}
+
+			bool ExistsWriteLock() const {
+				return (tid_word_.load(std::memory_order_relaxed) & kLockBit) != 0;
+			}
+
+			// only called by the holder of the write lock, which is kept.
+			void SetTimestamp(const uint64_t &timestamp) {
+				uint64_t tid_word = tid_word_.load(std::memory_order_relaxed);
+				assert((tid_word & kLockBit) != 0);
+				assert((timestamp & kLockBit) == 0);
+				assert((tid_word & ~kLockBit) <= timestamp);
+				tid_word_.store(timestamp | kLockBit, std::memory_order_release);
+			}
+
+			uint64_t GetTimestamp() const {
+				return tid_word_.load(std::memory_order_acquire) & ~kLockBit;
+			}
+
+			// timestamp and lock state as of the same instant.
+			uint64_t GetTimestamp(bool &is_locked) const {
+				uint64_t tid_word = tid_word_.load(std::memory_order_acquire);
+				is_locked = ((tid_word & kLockBit) != 0);
+				return tid_word & ~kLockBit;
+			}
+
+		private:
+			static const uint64_t kLockBit = 1ULL << 63;
+
+			std::atomic<uint64_t> tid_word_;
+		};
+	}
+}
+
+#endif
@@ -16,7 +16,10 @@
 #include "../Scheduler/SimpleScheduler.h"
 #include "../Scheduler/WaitSyncScheduler.h"
 #include "../Scheduler/SharedWorklistScheduler.h"
+#include "../Scheduler/WorkStealingScheduler.h"
+#include "../Scheduler/CCPolicy.h"
 #include "BaseExecutor.h"
+#include "RetryPolicy.h"
 #if defined(DBX) || defined(RTM) || defined(OCC_RTM) || defined(LOCK_RTM)
 #include <RtmLock.h>
 #endif
@@ -44,8 +47,18 @@ namespace Cavalia{
 				}
 				is_scheduler_ready_ = false;
 				memset(&time_lock_, 0, sizeof(time_lock_));
+				// new does not honor the cache-line alignment of RetryStatistics before c++17.
+				void *statistics_ptr = NULL;
+				int ret = posix_memalign(&statistics_ptr, 64, sizeof(RetryStatistics) * thread_count_);
+				assert(ret == 0);
+				retry_statistics_ = (RetryStatistics*)statistics_ptr;
+				for (size_t i = 0; i < thread_count_; ++i){
+					new(&retry_statistics_[i]) RetryStatistics();
+				}
 #if defined(WAIT_SYNC_SCHEDULER)
 				scheduler_ = new WaitSyncScheduler(redirector_ptr_, this, thread_count_);
+#elif defined(WORK_STEALING_SCHEDULER)
+				scheduler_ = new WorkStealingScheduler(redirector_ptr_, this, thread_count_);
 #elif defined(SHARED_WORKLIST_SCHEDULER)				
 				scheduler_ = new SharedWorklistScheduler(redirector_ptr_, this, thread_count_);
 #else
@@ -56,6 +69,11 @@ namespace Cavalia{
 			virtual ~ConcurrentExecutor(){
 				delete[] is_ready_;
 				is_ready_ = NULL;
+				for (size_t i = 0; i < thread_count_; ++i){
+					retry_statistics_[i].~RetryStatistics();
+				}
+				free(retry_statistics_);
+				retry_statistics_ = NULL;
 			}
 
 			virtual void Start(){
@@ -93,6 +111,10 @@ namespace Cavalia{
 
 				// epoch generator.
 				Epoch epoch;
+#if defined(MVTO) || defined(MVLOCK) || defined(MVLOCK_WAIT) || defined(MVOCC) || defined(SILOCK) || defined(SIOCC)
+				// snapshot and garbage-collection watermarks.
+				Watermark watermark;
+#endif
 				std::cout << "start processing..." << std::endl;
 				is_begin_ = true;
 				start_timestamp_ = timer_.GetTimePoint();
@@ -102,10 +124,14 @@ namespace Cavalia{
 				double per_core_throughput = throughput / thread_count_;
 				std::cout << "execute_count=" << total_count_ <<", abort_count=" << total_abort_count_ <<", abort_rate=" <<  total_abort_count_*1.0 / (total_count_ + 1) << std::endl;
 				std::cout << "elapsed time=" << elapsed_time << "ms.\nthroughput=" << throughput << "K tps.\nper-core throughput=" << per_core_throughput << "K tps." << std::endl;
+				ReportRetryStatistics();
 #if defined(DBX) || defined(RTM) || defined(OCC_RTM) || defined(LOCK_RTM)
 #if defined(PROFILE_RTM)
 				rtm_lock_.Print();
 #endif
+#endif
+#if defined(DYNAMIC_CC)
+				cc_feedback_.Report();
 #endif
 			}
 
@@ -123,11 +149,7 @@ namespace Cavalia{
 #if defined(DBX) || defined(RTM) || defined(OCC_RTM) || defined(LOCK_RTM)
 				txn_manager->SetRtmLock(&rtm_lock_);
 #endif
-				StoredProcedure **procedures = new StoredProcedure*[registers_.size()];
-				for (auto &entry : registers_){
-					procedures[entry.first] = entry.second(node_id);
-					procedures[entry.first]->SetTransactionManager(txn_manager);
-				}
+				StoredProcedure **procedures = CreateProcedures(txn_manager, node_id);
 #if defined(VALUE_LOGGING) || defined(COMMAND_LOGGING)
 				logger_->RegisterThread(thread_id, core_id);
 #endif
@@ -142,9 +164,76 @@ namespace Cavalia{
 				ret.char_ptr_ = new char[1024];
 				ExeContext exe_context;
 				ParamBatch* tuples = NULL;
+				RetryQueue retry_queue;
+				RetryStatistics &retry_statistics = retry_statistics_[thread_id];
+				bool is_requeued = (gRetryPolicy == BATCH_END_RETRY || gRetryPolicy == DEADLINE_RETRY);
+				// without a barrier there is no serial lane, and repeat offenders keep spinning.
+				bool has_serial_lane = (gRetryPolicy == SERIAL_LANE_RETRY && scheduler_->CanDeferTransaction());
+
+				// executes the requeued transactions that are due, or all of them with is_draining.
+				// returns false once the run is over.
+				auto process_retry_queue = [&](const bool is_draining) -> bool {
+					while (retry_queue.IsEmpty() == false){
+						if (retry_queue.IsDue(GetRetryClock()) == false){
+							if (is_draining == false){
+								return true;
+							}
+							retry_statistics.BeginBackoff();
+							while (retry_queue.IsDue(GetRetryClock()) == false){
+								_mm_pause();
+							}
+							retry_statistics.EndBackoff();
+						}
+						RetryEntry entry = retry_queue.Pop();
+						TxnParam *tuple = entry.txn_;
+						BEGIN_TRANSACTION_TIME_MEASURE(thread_id);
+						ret.size_ = 0;
+						exe_context.is_retry_ = true;
+#if defined(RECONNAISSANCE)
+						exe_context.recon_rw_set_ = tuple->is_reconnoitered_ ? &tuple->GetReadWriteSet() : NULL;
+#endif
+						retry_statistics.BeginAttempt();
+						if (procedures[tuple->type_]->Execute(tuple, ret, exe_context) == false){
+							retry_statistics.AbortAttempt();
+							ret.size_ = 0;
+							++abort_count;
+							END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+							if (is_finish_ == true){
+								return false;
+							}
+#if defined(RECONNAISSANCE)
+							if (txn_manager->is_reconnaissance_stale_ == true){
+								txn_manager->is_reconnaissance_stale_ = false;
+								scheduler_->DeferTransaction(thread_id, tuple);
+								continue;
+							}
+#endif
+							retry_queue.Push(tuple, entry.attempts_ + 1, GetRetryClock());
+							continue;
+						}
+						++count;
+						END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+						if (is_finish_ == true){
+							return false;
+						}
+					}
+					return true;
+				};
 
 				while((tuples = scheduler_->GetNextBatch(thread_id)) != NULL) {
+#if defined(DYNAMIC_CC)
+					exe_context.cc_type_ = tuples->cc_type_;
+					int batch_count = count;
+					int batch_abort_count = abort_count;
+					cc_feedback_.BeginBatch(thread_id);
+#endif
 					for (size_t idx = 0; idx < tuples->size(); ++idx) {
+						if (gRetryPolicy == DEADLINE_RETRY && process_retry_queue(false) == false){
+							total_count_ += count;
+							total_abort_count_ += abort_count;
+							txn_manager->CleanUp();
+							return;
+						}
 						TxnParam *tuple = tuples->get(idx);
 						//double a = r.next_uniform();
 						//if (a < gAdhocRatio*1.0 / 100){
@@ -153,9 +242,24 @@ namespace Cavalia{
 						BEGIN_TRANSACTION_TIME_MEASURE(thread_id);
 						ret.size_ = 0;
 						exe_context.is_retry_ = false;
+#if defined(RECONNAISSANCE)
+						exe_context.recon_rw_set_ = tuple->is_reconnoitered_ ? &tuple->GetReadWriteSet() : NULL;
+#endif
+						retry_statistics.BeginAttempt();
 						if (procedures[tuple->type_]->Execute(tuple, ret, exe_context) == false){
+							retry_statistics.AbortAttempt();
 							ret.size_ = 0;
 							++abort_count;
+							++retry_statistics.retried_count_;
+#if defined(RECONNAISSANCE)
+							if (txn_manager->is_reconnaissance_stale_ == true){
+								// retrying cannot help, the transaction runs alone at the end of the super-batch.
+								txn_manager->is_reconnaissance_stale_ = false;
+								scheduler_->DeferTransaction(thread_id, tuple);
+								END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+								continue;
+							}
+#endif
 							if (is_finish_ == true){
 								total_count_ += count;
 								total_abort_count_ += abort_count;
@@ -163,23 +267,41 @@ namespace Cavalia{
 								txn_manager->CleanUp();
 								return;
 							}
+							if (is_requeued == true){
+								// the worker moves on with its atomic-batch instead of spinning on the same items.
+								retry_queue.Push(tuple, 1, GetRetryClock());
+								END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+								continue;
+							}
 							BEGIN_CC_ABORT_TIME_MEASURE(thread_id);
 							exe_context.is_retry_ = true;
 							if (backoff_shifts < 63){
 								++backoff_shifts;
 							}
+							size_t attempts = 1;
+							bool is_serialized = false;
 							uint64_t spins = 1UL << backoff_shifts;
 #if defined(BACKOFF)
 							spins *= 100;
+							retry_statistics.BeginBackoff();
 							while (spins){
 								_mm_pause();
 								--spins;
 							}
+							retry_statistics.EndBackoff();
 #endif
+							retry_statistics.BeginAttempt();
 							while (procedures[tuple->type_]->Execute(tuple, ret, exe_context) == false){
+								retry_statistics.AbortAttempt();
 								exe_context.is_retry_ = true;
 								ret.size_ = 0;
 								++abort_count;
+								++attempts;
+#if defined(RECONNAISSANCE)
+								if (txn_manager->is_reconnaissance_stale_ == true){
+									break;
+								}
+#endif
 								if (is_finish_ == true){
 									total_count_ += count;
 									total_abort_count_ += abort_count;
@@ -188,16 +310,38 @@ namespace Cavalia{
 									txn_manager->CleanUp();
 									return;
 								}
+								if (has_serial_lane == true && attempts >= RETRY_SERIAL_THRESHOLD){
+									is_serialized = true;
+									break;
+								}
 #if defined(BACKOFF)
 								uint64_t spins = 1UL << backoff_shifts;
 								spins *= 100;
+								retry_statistics.BeginBackoff();
 								while (spins){
 									_mm_pause();
 									--spins;
 								}
+								retry_statistics.EndBackoff();
 #endif
+								retry_statistics.BeginAttempt();
 							}
 							END_CC_ABORT_TIME_MEASURE(thread_id);
+							if (is_serialized == true){
+								// a repeat offender runs alone at the end of the super-batch, where it cannot abort.
+								++retry_statistics.serial_count_;
+								scheduler_->DeferTransaction(thread_id, tuple);
+								END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+								continue;
+							}
+#if defined(RECONNAISSANCE)
+							if (txn_manager->is_reconnaissance_stale_ == true){
+								txn_manager->is_reconnaissance_stale_ = false;
+								scheduler_->DeferTransaction(thread_id, tuple);
+								END_TRANSACTION_TIME_MEASURE(thread_id, tuple->type_);
+								continue;
+							}
+#endif
 						}
 						else{
 #if defined(BACKOFF)
@@ -213,6 +357,17 @@ namespace Cavalia{
 							return;
 						}
 					}
+					// the atomic-batch is only complete once its requeued transactions have committed.
+					if (process_retry_queue(true) == false){
+						total_count_ += count;
+						total_abort_count_ += abort_count;
+						txn_manager->CleanUp();
+						return;
+					}
+#if defined(DYNAMIC_CC)
+					// transactions deferred to the barrier are counted by the batch that commits them.
+					cc_feedback_.EndBatch(thread_id, count - batch_count, abort_count - batch_abort_count);
+#endif
 				}
 					
 				time_lock_.lock();
@@ -233,10 +388,50 @@ namespace Cavalia{
 				/////////////////////////////////////////////////
 			}
 			
+			// wasted work of the retry policy, summed over the workers.
+			void ReportRetryStatistics(){
+				RetryStatistics total;
+				for (size_t i = 0; i < thread_count_; ++i){
+					total.retried_count_ += retry_statistics_[i].retried_count_;
+					total.serial_count_ += retry_statistics_[i].serial_count_;
+					total.wasted_time_ += retry_statistics_[i].wasted_time_;
+					total.backoff_time_ += retry_statistics_[i].backoff_time_;
+				}
+				std::cout << "retry_policy=" << GetRetryPolicyName(gRetryPolicy) << ", retried_count=" << total.retried_count_ << ", serial_count=" << total.serial_count_;
+#if !defined(MUTE) && defined(PROFILE_RETRY)
+				std::cout << ", wasted_time=" << total.wasted_time_ / 1000000 << "ms, backoff_time=" << total.backoff_time_ / 1000000 << "ms";
+#endif
+				std::cout << std::endl;
+			}
+
 			size_t GetCoreId(const size_t &thread_id){
 				return thread_id;
 			}
 
+			// one procedure per registered transaction type, all running through txn_manager.
+			StoredProcedure** CreateProcedures(TransactionManager *txn_manager, const size_t &node_id){
+				StoredProcedure **procedures = new StoredProcedure*[registers_.size()];
+				for (auto &entry : registers_){
+					procedures[entry.first] = entry.second(node_id);
+					procedures[entry.first]->SetTransactionManager(txn_manager);
+				}
+				return procedures;
+			}
+
+			// frees procedures returned by CreateProcedures through the deregisters of the benchmark.
+			void DestroyProcedures(StoredProcedure **procedures){
+				for (auto &entry : deregisters_){
+					entry.second((char*)(procedures[entry.first]));
+					procedures[entry.first] = NULL;
+				}
+				delete[] procedures;
+				procedures = NULL;
+			}
+
+			BaseStorageManager* GetStorageManager() const {
+				return storage_manager_;
+			}
+
 		private:
 			ConcurrentExecutor(const ConcurrentExecutor &);
 			ConcurrentExecutor& operator=(const ConcurrentExecutor &);
@@ -256,6 +451,8 @@ namespace Cavalia{
 			volatile bool is_finish_;
 			std::atomic<size_t> total_count_;
 			std::atomic<size_t> total_abort_count_;
+			// one per worker.
+			RetryStatistics *retry_statistics_;
 #if defined(DBX) || defined(RTM) || defined(OCC_RTM) || defined(LOCK_RTM)
 			RtmLock rtm_lock_;
 #endif
@@ -62,6 +62,10 @@ namespace Cavalia {
 				}
 				// epoch generator.
 				Epoch epoch;
+#if defined(MVTO) || defined(MVLOCK) || defined(MVLOCK_WAIT) || defined(MVOCC) || defined(SILOCK) || defined(SIOCC)
+				// snapshot and garbage-collection watermarks.
+				Watermark watermark;
+#endif
 				std::cout << "start processing..." << std::endl;
 				is_begin_ = true;
 				start_timestamp_ = timer_.GetTimePoint();
@@ -0,0 +1,141 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_RETRY_POLICY_H__
+#define __CAVALIA_DATABASE_RETRY_POLICY_H__
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <immintrin.h>
+#include "../Meta/MetaTypes.h"
+#include "../Transaction/TxnParam.h"
+
+// backoff before the first retry of a requeued transaction, doubled on every further abort, in nanoseconds.
+#if !defined(RETRY_BACKOFF_NS)
+#define RETRY_BACKOFF_NS 1000
+#endif
+// aborts after which SERIAL_LANE_RETRY hands a transaction to the serial lane.
+#if !defined(RETRY_SERIAL_THRESHOLD)
+#define RETRY_SERIAL_THRESHOLD 4
+#endif
+#define RETRY_MAX_BACKOFF_SHIFTS 10
+
+namespace Cavalia{
+	namespace Database{
+		static inline uint64_t GetRetryClock(){
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		static inline const char* GetRetryPolicyName(const size_t &policy){
+			static const char *names[kRetryPolicyTypeSize] = { "spin", "batch_end", "deadline", "serial_lane" };
+			return names[policy];
+		}
+
+		struct RetryEntry{
+			TxnParam *txn_;
+			uint64_t deadline_;
+			// aborts so far.
+			size_t attempts_;
+		};
+
+		struct RetryEntryLater{
+			bool operator()(const RetryEntry &lhs, const RetryEntry &rhs) const{
+				return lhs.deadline_ > rhs.deadline_;
+			}
+		};
+
+		/*
+		** Class RetryQueue:
+		** -----------------
+		** Per-worker queue of aborted transactions, ordered by the deadline of their exponential backoff.
+		** With BATCH_END_RETRY the worker executes them once it is through its atomic-batch, with
+		** DEADLINE_RETRY also between two transactions of the atomic-batch as soon as they are due. Either
+		** way the queue is drained before the worker asks the scheduler for the next atomic-batch, so the
+		** atomic-batch still completes as a whole.
+		*/
+		class RetryQueue{
+		public:
+			RetryQueue() : entries_(){}
+
+			void Push(TxnParam *txn, const size_t &attempts, const uint64_t &now){
+				size_t shifts = attempts - 1;
+				if (shifts > RETRY_MAX_BACKOFF_SHIFTS){
+					shifts = RETRY_MAX_BACKOFF_SHIFTS;
+				}
+				RetryEntry entry;
+				entry.txn_ = txn;
+				entry.deadline_ = now + ((uint64_t)RETRY_BACKOFF_NS << shifts);
+				entry.attempts_ = attempts;
+				entries_.push(entry);
+			}
+
+			RetryEntry Pop(){
+				RetryEntry entry = entries_.top();
+				entries_.pop();
+				return entry;
+			}
+
+			bool IsDue(const uint64_t &now) const{
+				return entries_.empty() == false && entries_.top().deadline_ <= now;
+			}
+
+			bool IsEmpty() const{
+				return entries_.empty();
+			}
+
+			uint64_t GetNextDeadline() const{
+				return entries_.top().deadline_;
+			}
+
+		private:
+			RetryQueue(const RetryQueue &);
+			RetryQueue& operator=(const RetryQueue &);
+
+		private:
+			std::priority_queue<RetryEntry, std::vector<RetryEntry>, RetryEntryLater> entries_;
+		};
+
+		// what aborts cost a worker. times are only measured with -DPROFILE_RETRY.
+#ifdef __linux__
+		struct __attribute__((aligned(64))) RetryStatistics{
+#else
+		struct RetryStatistics{
+#endif
+			RetryStatistics() : retried_count_(0), serial_count_(0), wasted_time_(0), backoff_time_(0), begin_time_(0){}
+
+			void BeginAttempt(){
+#if !defined(MUTE) && defined(PROFILE_RETRY)
+				begin_time_ = GetRetryClock();
+#endif
+			}
+
+			void AbortAttempt(){
+#if !defined(MUTE) && defined(PROFILE_RETRY)
+				wasted_time_ += GetRetryClock() - begin_time_;
+#endif
+			}
+
+			void BeginBackoff(){
+#if !defined(MUTE) && defined(PROFILE_RETRY)
+				begin_time_ = GetRetryClock();
+#endif
+			}
+
+			void EndBackoff(){
+#if !defined(MUTE) && defined(PROFILE_RETRY)
+				backoff_time_ += GetRetryClock() - begin_time_;
+#endif
+			}
+
+			// transactions that aborted at least once, and those among them sent to the serial lane.
+			size_t retried_count_;
+			size_t serial_count_;
+			// nanoseconds spent in attempts that aborted, and waiting before a retry.
+			uint64_t wasted_time_;
+			uint64_t backoff_time_;
+			uint64_t begin_time_;
+		};
+	}
+}
+
+#endif
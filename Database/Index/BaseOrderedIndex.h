@@ -14,6 +14,8 @@ namespace Cavalia{
 
 			virtual void InsertRecord(const std::string&, TableRecord *) = 0;
 			virtual void DeleteRecord(const std::string&) = 0;
+			// secondary keys are not unique, this only removes the entry of the given record.
+			virtual void DeleteRecord(const std::string&, TableRecord *) = 0;
 			virtual TableRecord* SearchRecord(const std::string&) = 0;
 			virtual void SearchRecords(const std::string&, TableRecords*) = 0;
 			virtual void SearchUpperRecords(const std::string&, TableRecords*) = 0;
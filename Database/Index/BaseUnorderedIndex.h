@@ -5,6 +5,7 @@
 #include <string>
 #include <fstream>
 #include "../Storage/TableRecord.h"
+#include "../Storage/FixedKey.h"
 
 namespace Cavalia{
 	namespace Database{
@@ -16,6 +17,16 @@ namespace Cavalia{
 			virtual bool InsertRecord(const std::string&, TableRecord *) = 0;
 			virtual bool DeleteRecord(const std::string&) = 0;
 			virtual TableRecord* SearchRecord(const std::string&) = 0;
+			// fixed-width keys reach the string interface unless the index stores them natively.
+			virtual bool InsertRecord(const FixedKey &key, TableRecord *record){
+				return InsertRecord(key.ToString(), record);
+			}
+			virtual bool DeleteRecord(const FixedKey &key){
+				return DeleteRecord(key.ToString());
+			}
+			virtual TableRecord* SearchRecord(const FixedKey &key){
+				return SearchRecord(key.ToString());
+			}
 			virtual size_t GetSize() const = 0;
 			virtual void SaveCheckpoint(std::ofstream &, const size_t &) = 0;
 
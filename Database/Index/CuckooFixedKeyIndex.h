@@ -0,0 +1,68 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_CUCKOO_FIXED_KEY_INDEX_H__
+#define __CAVALIA_DATABASE_CUCKOO_FIXED_KEY_INDEX_H__
+
+#include <libcuckoo/cuckoohash_map.hh>
+#include "BaseUnorderedIndex.h"
+
+namespace Cavalia{
+	namespace Database {
+		class CuckooFixedKeyIndex : public BaseUnorderedIndex{
+			typedef cuckoohash_map<FixedKey, TableRecord*, FixedKeyHasher> CuckooMap;
+		public:
+			CuckooFixedKeyIndex(){}
+			virtual ~CuckooFixedKeyIndex(){}
+
+			virtual bool InsertRecord(const std::string &key, TableRecord *record){
+				return InsertRecord(FixedKey(key.data(), key.size()), record);
+			}
+
+			virtual bool DeleteRecord(const std::string &key){
+				return DeleteRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual TableRecord* SearchRecord(const std::string &key){
+				return SearchRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual bool InsertRecord(const FixedKey &key, TableRecord *record){
+				return hash_index_.insert(key, record);
+			}
+
+			virtual bool DeleteRecord(const FixedKey &key){
+				return hash_index_.erase(key);
+			}
+
+			virtual TableRecord* SearchRecord(const FixedKey &key){
+				TableRecord *record;
+				if (hash_index_.find(key, record) == true){
+					return record;
+				}
+				else{
+					return NULL;
+				}
+			}
+
+			virtual size_t GetSize() const {
+				return hash_index_.size();
+			}
+
+			virtual void SaveCheckpoint(std::ofstream &out_stream, const size_t &record_size){
+				auto lt = hash_index_.lock_table();
+				for (const auto &it : lt) {
+					out_stream.write(it.second->record_->data_ptr_, record_size);
+				}
+				out_stream.flush();
+			}
+
+		private:
+			CuckooFixedKeyIndex(const CuckooFixedKeyIndex &);
+			CuckooFixedKeyIndex& operator=(const CuckooFixedKeyIndex &);
+
+		private:
+			CuckooMap hash_index_;
+		};
+	}
+}
+
+#endif
@@ -19,8 +19,7 @@ namespace Cavalia{
 			}
 
 			virtual bool DeleteRecord(const std::string &key){
-				//hash_index_.erase(key);
-				return false;
+				return hash_index_.erase(key);
 			}
 
 			virtual TableRecord* SearchRecord(const std::string &key){
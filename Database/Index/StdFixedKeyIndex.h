@@ -0,0 +1,67 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_STD_FIXED_KEY_INDEX_H__
+#define __CAVALIA_DATABASE_STD_FIXED_KEY_INDEX_H__
+
+#include <unordered_map>
+#include "BaseUnorderedIndex.h"
+
+namespace Cavalia {
+	namespace Database {
+		// primary index of a table whose key fits in a FixedKey, so lookups neither allocate nor hash a string.
+		class StdFixedKeyIndex : public BaseUnorderedIndex {
+		public:
+			StdFixedKeyIndex() {}
+			virtual ~StdFixedKeyIndex() {}
+
+			virtual bool InsertRecord(const std::string &key, TableRecord *record) {
+				return InsertRecord(FixedKey(key.data(), key.size()), record);
+			}
+
+			virtual bool DeleteRecord(const std::string &key) {
+				return DeleteRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual TableRecord* SearchRecord(const std::string &key) {
+				return SearchRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual bool InsertRecord(const FixedKey &key, TableRecord *record) {
+				return hash_index_.insert(std::make_pair(key, record)).second;
+			}
+
+			virtual bool DeleteRecord(const FixedKey &key) {
+				return hash_index_.erase(key) != 0;
+			}
+
+			virtual TableRecord* SearchRecord(const FixedKey &key) {
+				auto it = hash_index_.find(key);
+				if (it == hash_index_.end()) {
+					return NULL;
+				}
+				else {
+					return it->second;
+				}
+			}
+
+			virtual size_t GetSize() const {
+				return hash_index_.size();
+			}
+
+			virtual void SaveCheckpoint(std::ofstream &out_stream, const size_t &record_size) {
+				for (auto &entry : hash_index_){
+					out_stream.write(entry.second->record_->data_ptr_, record_size);
+				}
+				out_stream.flush();
+			}
+
+		private:
+			StdFixedKeyIndex(const StdFixedKeyIndex &);
+			StdFixedKeyIndex& operator=(const StdFixedKeyIndex &);
+
+		protected:
+			std::unordered_map<FixedKey, TableRecord*, FixedKeyHasher> hash_index_;
+		};
+	}
+}
+
+#endif
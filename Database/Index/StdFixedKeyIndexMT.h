@@ -0,0 +1,59 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_STD_FIXED_KEY_INDEX_MT_H__
+#define __CAVALIA_DATABASE_STD_FIXED_KEY_INDEX_MT_H__
+
+#include <RWLock.h>
+#include "StdFixedKeyIndex.h"
+
+namespace Cavalia {
+	namespace Database {
+		class StdFixedKeyIndexMT : public StdFixedKeyIndex {
+		public:
+			StdFixedKeyIndexMT() {}
+			virtual ~StdFixedKeyIndexMT() {}
+
+			virtual bool InsertRecord(const std::string &key, TableRecord *record) {
+				return InsertRecord(FixedKey(key.data(), key.size()), record);
+			}
+
+			virtual bool DeleteRecord(const std::string &key) {
+				return DeleteRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual TableRecord* SearchRecord(const std::string &key) {
+				return SearchRecord(FixedKey(key.data(), key.size()));
+			}
+
+			virtual bool InsertRecord(const FixedKey &key, TableRecord *record) {
+				lock_.AcquireWriteLock();
+				bool ret = hash_index_.insert(std::make_pair(key, record)).second;
+				lock_.ReleaseWriteLock();
+				return ret;
+			}
+
+			virtual bool DeleteRecord(const FixedKey &key) {
+				lock_.AcquireWriteLock();
+				bool ret = (hash_index_.erase(key) != 0);
+				lock_.ReleaseWriteLock();
+				return ret;
+			}
+
+			virtual TableRecord* SearchRecord(const FixedKey &key) {
+				lock_.AcquireReadLock();
+				auto it = hash_index_.find(key);
+				TableRecord *ret_record = (it == hash_index_.end()) ? NULL : it->second;
+				lock_.ReleaseReadLock();
+				return ret_record;
+			}
+
+		private:
+			StdFixedKeyIndexMT(const StdFixedKeyIndexMT &);
+			StdFixedKeyIndexMT& operator=(const StdFixedKeyIndexMT &);
+
+		protected:
+			RWLock lock_;
+		};
+	}
+}
+
+#endif
@@ -20,6 +20,16 @@ namespace Cavalia {
 				index_.erase(key);
 			}
 
+			virtual void DeleteRecord(const std::string &key, TableRecord *record) {
+				auto range = index_.equal_range(key);
+				for (auto it = range.first; it != range.second; ++it) {
+					if (it->second == record) {
+						index_.erase(it);
+						return;
+					}
+				}
+			}
+
 			virtual TableRecord* SearchRecord(const std::string &key) {
 				if (index_.find(key) == index_.end()) {
 					return NULL;
@@ -24,6 +24,12 @@ namespace Cavalia {
 				lock_.ReleaseWriteLock();
 			}
 
+			virtual void DeleteRecord(const std::string &key, TableRecord *record) {
+				lock_.AcquireWriteLock();
+				StdOrderedIndex::DeleteRecord(key, record);
+				lock_.ReleaseWriteLock();
+			}
+
 			virtual TableRecord* SearchRecord(const std::string &key) {
 				lock_.AcquireReadLock();
 				if (index_.find(key) == index_.end()) {
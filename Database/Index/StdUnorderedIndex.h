@@ -29,13 +29,7 @@ namespace Cavalia {
 			}
 
 			virtual bool DeleteRecord(const std::string &key) {
-				if (hash_index_.find(key) == hash_index_.end()){
-					return false;
-				}
-				else{
-					//hash_index_.erase(key);
-					return true;
-				}
+				return hash_index_.erase(key) != 0;
 			}
 
 			virtual TableRecord* SearchRecord(const std::string &key) {
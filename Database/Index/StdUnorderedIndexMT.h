@@ -27,15 +27,9 @@ namespace Cavalia {
 
 			virtual bool DeleteRecord(const std::string &key) {
 				lock_.AcquireWriteLock();
-				if (hash_index_.find(key) == hash_index_.end()){
-					lock_.ReleaseWriteLock();
-					return false;
-				}
-				else{
-					hash_index_.erase(key);
-					lock_.ReleaseWriteLock();
-					return true;
-				}
+				bool ret = (hash_index_.erase(key) != 0);
+				lock_.ReleaseWriteLock();
+				return ret;
 			}
 
 			virtual TableRecord* SearchRecord(const std::string &key) {
@@ -8,6 +8,13 @@
 #if defined(__linux__)
 #include <unistd.h>
 #endif
+#if defined(ASYNC_LOGGING)
+#include <vector>
+#include <sys/uio.h>
+#include <immintrin.h>
+#include <boost/thread.hpp>
+#include "../Transaction/Epoch.h"
+#endif
 #if defined(COMPRESSION)
 #include <lz4frame.h>
 #endif
@@ -18,6 +25,11 @@
 #include "../Meta/MetaTypes.h"
 #include "ThreadLogBuffer.h"
 
+// workers served by each flusher thread with -DASYNC_LOGGING.
+#if !defined(LOG_WORKERS_PER_FLUSHER)
+#define LOG_WORKERS_PER_FLUSHER 8
+#endif
+
 namespace Cavalia{
 	namespace Database{
 		class BaseLogger{
@@ -47,8 +59,41 @@ namespace Cavalia{
 					}
 				}
 				thread_log_buffer_ = new ThreadLogBuffer*[thread_count_];
+#if defined(ASYNC_LOGGING)
+				// new does not honor the cache-line alignment of LogFlushSlot before c++17.
+				void *slots_ptr = NULL;
+				int ret = posix_memalign(&slots_ptr, 64, sizeof(LogFlushSlot) * thread_count_);
+				assert(ret == 0);
+				flush_slots_ = (LogFlushSlot*)slots_ptr;
+				for (size_t i = 0; i < thread_count_; ++i){
+					new(&flush_slots_[i]) LogFlushSlot();
+				}
+				durable_epoch_ = 0;
+				is_running_ = true;
+				flusher_count_ = (thread_count_ + LOG_WORKERS_PER_FLUSHER - 1) / LOG_WORKERS_PER_FLUSHER;
+				flushers_ = new boost::thread*[flusher_count_];
+				for (size_t i = 0; i < flusher_count_; ++i){
+					flushers_[i] = new boost::thread(boost::bind(&BaseLogger::FlushLogs, this, i));
+				}
+#endif
 			}
 			virtual ~BaseLogger(){
+#if defined(ASYNC_LOGGING)
+				// the flushers write out whatever was handed to them before they stop.
+				is_running_ = false;
+				for (size_t i = 0; i < flusher_count_; ++i){
+					flushers_[i]->join();
+					delete flushers_[i];
+					flushers_[i] = NULL;
+				}
+				delete[] flushers_;
+				flushers_ = NULL;
+				for (size_t i = 0; i < thread_count_; ++i){
+					flush_slots_[i].~LogFlushSlot();
+				}
+				free(flush_slots_);
+				flush_slots_ = NULL;
+#endif
 				for (size_t i = 0; i < thread_count_; ++i){
 					int ret;
 					ret = fflush(outfiles_[i]);
@@ -76,6 +121,17 @@ namespace Cavalia{
 #else
 				thread_log_buffer_[thread_id] = (ThreadLogBuffer*)MemAllocator::AllocNode(sizeof(ThreadLogBuffer), numa_node_id);
 				new(thread_log_buffer_[thread_id])ThreadLogBuffer(buffer_ptr);
+#endif
+#if defined(ASYNC_LOGGING)
+				thread_log_buffer_[thread_id]->spare_buffer_ptr_ = MemAllocator::AllocNode(kLogBufferSize, numa_node_id);
+				LogFlushSlot &slot = flush_slots_[thread_id];
+#if defined(COMPRESSION)
+				// only the flusher compresses.
+				slot.compressed_buffer_ptr_ = compressed_buffer_ptr;
+#endif
+				// the worker logs into no epoch older than the current one.
+				slot.open_epoch_.store(Epoch::GetEpoch(), std::memory_order_relaxed);
+				slot.is_registered_.store(true, std::memory_order_release);
 #endif
 			}
 
@@ -86,6 +142,16 @@ namespace Cavalia{
 			virtual void CommitTransaction(const size_t &thread_id, const uint64_t &epoch, const uint64_t &commit_ts, const size_t &txn_type, TxnParam *param) = 0;
 
 			void CleanUp(const size_t &thread_id){
+#if defined(ASYNC_LOGGING)
+				LogFlushSlot &slot = flush_slots_[thread_id];
+				// the last buffer goes out behind the punctuation, and the worker waits until it is durable.
+				HandOffBuffer(thread_id, -1);
+				while (slot.is_pending_.load(std::memory_order_acquire) == true){
+					_mm_pause();
+				}
+				// the worker logs nothing anymore and no longer holds back the durable epoch.
+				slot.open_epoch_.store(kMaxDurableEpoch, std::memory_order_release);
+#else
 				ThreadLogBuffer *buf_struct_ptr = thread_log_buffer_[thread_id];
 				size_t &buffer_offset_ref = buf_struct_ptr->buffer_offset_;
 				FILE *file_ptr = outfiles_[thread_id];
@@ -117,8 +183,129 @@ namespace Cavalia{
 				result = fsync(fileno(file_ptr));
 				assert(result == 0);
 #endif
+#endif
+			}
+
+#if defined(ASYNC_LOGGING)
+			// every transaction logged in an epoch up to this one is durable.
+			uint64_t GetDurableEpoch() const {
+				return durable_epoch_.load(std::memory_order_acquire);
+			}
+#endif
+
+		protected:
+#if defined(ASYNC_LOGGING)
+			// hands the filled buffer of the worker under the epoch header to its flusher, and continues in the spare buffer.
+			// the worker only waits if the flusher has not yet written the spare buffer out.
+			void HandOffBuffer(const size_t &thread_id, const uint64_t &header_epoch){
+				ThreadLogBuffer *tlb_ptr = thread_log_buffer_[thread_id];
+				LogFlushSlot &slot = flush_slots_[thread_id];
+				while (slot.is_pending_.load(std::memory_order_acquire) == true){
+					_mm_pause();
+				}
+				slot.buffer_ptr_ = tlb_ptr->buffer_ptr_;
+				slot.buffer_size_ = tlb_ptr->buffer_offset_;
+				slot.epoch_ = header_epoch;
+				slot.is_pending_.store(true, std::memory_order_release);
+				char *buffer_ptr = tlb_ptr->buffer_ptr_;
+				tlb_ptr->buffer_ptr_ = tlb_ptr->spare_buffer_ptr_;
+				tlb_ptr->spare_buffer_ptr_ = buffer_ptr;
+				tlb_ptr->buffer_offset_ = 0;
+			}
+
+			// moves the worker to a new epoch, after the buffer of the last one was handed off.
+			void OpenEpoch(const size_t &thread_id, const uint64_t &epoch){
+				thread_log_buffer_[thread_id]->last_epoch_ = epoch;
+				flush_slots_[thread_id].open_epoch_.store(epoch, std::memory_order_release);
+			}
+#endif
+
+		private:
+#if defined(ASYNC_LOGGING)
+			// group commit: a flusher first writes the buffers handed off by all of its workers, then syncs their files,
+			// and only then releases the buffers and advances the durable epoch.
+			void FlushLogs(const size_t &flusher_id){
+				std::vector<size_t> flushed;
+				while (true){
+					// read before scanning, so that the last round sees every buffer handed off before the logger stops.
+					bool is_running = is_running_.load(std::memory_order_acquire);
+					flushed.clear();
+					for (size_t i = flusher_id; i < thread_count_; i += flusher_count_){
+						if (flush_slots_[i].is_pending_.load(std::memory_order_acquire) == true){
+							WriteBuffer(i);
+							flushed.push_back(i);
+						}
+					}
+					for (auto thread_id : flushed){
+#if defined(__linux__)
+						int result = fdatasync(fileno(outfiles_[thread_id]));
+						assert(result == 0);
+#endif
+						flush_slots_[thread_id].is_pending_.store(false, std::memory_order_release);
+					}
+					UpdateDurableEpoch(flusher_id);
+					if (flushed.size() == 0){
+						if (is_running == false){
+							return;
+						}
+						boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+					}
+				}
+			}
+
+			// | epoch | size | buffer |, the same frame as the synchronous path, in a single positional write.
+			void WriteBuffer(const size_t &thread_id){
+				LogFlushSlot &slot = flush_slots_[thread_id];
+				char *payload_ptr = slot.buffer_ptr_;
+				size_t payload_size = slot.buffer_size_;
+#if defined(COMPRESSION)
+				size_t bound = LZ4F_compressFrameBound(slot.buffer_size_, NULL);
+				payload_size = LZ4F_compressFrame(slot.compressed_buffer_ptr_, bound, slot.buffer_ptr_, slot.buffer_size_, NULL);
+				assert(LZ4F_isError(payload_size) == false);
+				payload_ptr = slot.compressed_buffer_ptr_;
+#endif
+				struct iovec iov[3];
+				iov[0].iov_base = &slot.epoch_;
+				iov[0].iov_len = sizeof(uint64_t);
+				iov[1].iov_base = &payload_size;
+				iov[1].iov_len = sizeof(size_t);
+				iov[2].iov_base = payload_ptr;
+				iov[2].iov_len = payload_size;
+				ssize_t result = pwritev(fileno(outfiles_[thread_id]), iov, 3, slot.file_offset_);
+				assert(result == (ssize_t)(sizeof(uint64_t) + sizeof(size_t) + payload_size));
+				slot.file_offset_ += result;
 			}
 
+			void UpdateDurableEpoch(const size_t &flusher_id){
+				for (size_t i = flusher_id; i < thread_count_; i += flusher_count_){
+					LogFlushSlot &slot = flush_slots_[i];
+					if (slot.is_registered_.load(std::memory_order_acquire) == false){
+						continue;
+					}
+					// the open epoch is read first: a handoff it already reflects is still pending or synced by now.
+					uint64_t open_epoch = slot.open_epoch_.load(std::memory_order_acquire);
+					if (slot.is_pending_.load(std::memory_order_acquire) == true && slot.epoch_ < open_epoch){
+						open_epoch = slot.epoch_;
+					}
+					slot.durable_epoch_.store(open_epoch - 1, std::memory_order_release);
+				}
+				uint64_t min_epoch = kMaxDurableEpoch;
+				for (size_t i = 0; i < thread_count_; ++i){
+					if (flush_slots_[i].is_registered_.load(std::memory_order_acquire) == true){
+						uint64_t epoch = flush_slots_[i].durable_epoch_.load(std::memory_order_acquire);
+						if (epoch < min_epoch){
+							min_epoch = epoch;
+						}
+					}
+				}
+				if (min_epoch == kMaxDurableEpoch){
+					return;
+				}
+				uint64_t durable_epoch = durable_epoch_.load(std::memory_order_relaxed);
+				while (durable_epoch < min_epoch && durable_epoch_.compare_exchange_weak(durable_epoch, min_epoch, std::memory_order_release) == false);
+			}
+#endif
+
 		private:
 			BaseLogger(const BaseLogger &);
 			BaseLogger& operator=(const BaseLogger &);
@@ -130,6 +317,17 @@ namespace Cavalia{
 
 		protected:
 			ThreadLogBuffer **thread_log_buffer_;
+
+#if defined(ASYNC_LOGGING)
+		private:
+			static const uint64_t kMaxDurableEpoch = (uint64_t)-1;
+
+			LogFlushSlot *flush_slots_;
+			boost::thread **flushers_;
+			size_t flusher_count_;
+			std::atomic<bool> is_running_;
+			std::atomic<uint64_t> durable_epoch_;
+#endif
 		};
 	}
 }
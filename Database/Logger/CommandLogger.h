@@ -21,6 +21,10 @@ namespace Cavalia {
 				}
 				else if (tlb_ptr->last_epoch_ != epoch){
 					assert(tlb_ptr->last_epoch_ + 1 == epoch);
+#if defined(ASYNC_LOGGING)
+					HandOffBuffer(thread_id, tlb_ptr->last_epoch_);
+					OpenEpoch(thread_id, epoch);
+#else
 					FILE *file_ptr = outfiles_[thread_id];
 					int result;
 					// record epoch.
@@ -50,6 +54,7 @@ namespace Cavalia {
 #if defined(__linux__)
 					result = fsync(fileno(file_ptr));
 					assert(result == 0);
+#endif
 #endif
 				}
 				char *curr_buffer_ptr = tlb_ptr->buffer_ptr_ + buffer_offset_ref;
@@ -103,6 +108,10 @@ namespace Cavalia {
 				}
 				else if (tlb_ptr->last_epoch_ != epoch){
 					assert(tlb_ptr->last_epoch_ + 1 == epoch);
+#if defined(ASYNC_LOGGING)
+					HandOffBuffer(thread_id, tlb_ptr->last_epoch_);
+					OpenEpoch(thread_id, epoch);
+#else
 					FILE *file_ptr = outfiles_[thread_id];
 					int result;
 					// record epoch.
@@ -132,6 +141,7 @@ namespace Cavalia {
 #if defined(__linux__)
 					result = fsync(fileno(file_ptr));
 					assert(result == 0);
+#endif
 #endif
 				}
 				char *curr_buffer_ptr = tlb_ptr->buffer_ptr_ + buffer_offset_ref;
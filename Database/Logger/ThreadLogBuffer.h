@@ -2,7 +2,9 @@
 #ifndef __CAVALIA_DATABASE_THREAD_LOG_BUFFER_H__
 #define __CAVALIA_DATABASE_THREAD_LOG_BUFFER_H__
 
+#include <cstddef>
 #include <cstdint>
+#include <atomic>
 
 namespace Cavalia{
 	namespace Database{
@@ -12,12 +14,18 @@ namespace Cavalia{
 				buffer_ptr_ = buffer_ptr;
 				buffer_offset_ = 0;
 				last_epoch_ = -1;
+#if defined(ASYNC_LOGGING)
+				spare_buffer_ptr_ = NULL;
+#endif
 			}
 #else
 			ThreadLogBuffer(char *buffer_ptr, char *compressed_buffer_ptr){
 				buffer_ptr_ = buffer_ptr;
 				buffer_offset_ = 0;
 				last_epoch_ = -1;
+#if defined(ASYNC_LOGGING)
+				spare_buffer_ptr_ = NULL;
+#endif
 
 				compressed_buffer_ptr_ = compressed_buffer_ptr;
 			}
@@ -27,8 +35,37 @@ namespace Cavalia{
 			uint64_t last_epoch_;
 #if defined(COMPRESSION)
 			char *compressed_buffer_ptr_;
+#endif
+#if defined(ASYNC_LOGGING)
+			// the buffer the flusher writes out while the worker fills buffer_ptr_.
+			char *spare_buffer_ptr_;
 #endif
 		};
+
+#if defined(ASYNC_LOGGING)
+		// a worker's filled buffer on its way to the flusher thread.
+#ifdef __linux__
+		struct __attribute__((aligned(64))) LogFlushSlot{
+#else
+		struct LogFlushSlot{
+#endif
+			LogFlushSlot() : buffer_ptr_(NULL), buffer_size_(0), epoch_(0), compressed_buffer_ptr_(NULL), file_offset_(0), is_pending_(false), is_registered_(false), open_epoch_(0), durable_epoch_(0){}
+
+			// written by the worker before it sets is_pending_, which the flusher clears once they are synced.
+			char *buffer_ptr_;
+			size_t buffer_size_;
+			uint64_t epoch_;
+			// owned by the flusher.
+			char *compressed_buffer_ptr_;
+			uint64_t file_offset_;
+			std::atomic<bool> is_pending_;
+			std::atomic<bool> is_registered_;
+			// no log of the worker below this epoch is still in its current buffer.
+			std::atomic<uint64_t> open_epoch_;
+			// all of the worker's log up to this epoch is on disk.
+			std::atomic<uint64_t> durable_epoch_;
+		};
+#endif
 	}
 }
 
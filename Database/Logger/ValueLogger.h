@@ -19,6 +19,10 @@ namespace Cavalia{
 					tlb_ptr->last_epoch_ = epoch;
 				} else if (tlb_ptr->last_epoch_ != epoch) {
 					assert(tlb_ptr->last_epoch_ < epoch);
+					#if defined(ASYNC_LOGGING)
+						HandOffBuffer(thread_id, tlb_ptr->last_epoch_);
+						OpenEpoch(thread_id, epoch);
+					#else
 					FILE *file_ptr = outfiles_[thread_id];
 					int result;
 					// record epoch.
@@ -49,6 +53,7 @@ namespace Cavalia{
 						result = fsync(fileno(file_ptr));
 						assert(result == 0);
 					#endif
+					#endif
 				}
 				char *curr_buffer_ptr = tlb_ptr->buffer_ptr_ + buffer_offset_ref;
 				memcpy(curr_buffer_ptr, (char*)(&commit_ts), sizeof(uint64_t));
@@ -5,5 +5,8 @@ namespace Cavalia{
 	namespace Database{
 		size_t gParamBatchSize = 1000;
 		size_t gAdhocRatio = 0;
+		size_t gPartitionThreadCount = 1;
+		size_t gPartitionerType = GREEDY_PARTITIONER;
+		size_t gRetryPolicy = SPIN_RETRY;
 	}
 }
\ No newline at end of file
@@ -10,6 +10,9 @@ namespace Cavalia{
 
 		extern size_t gParamBatchSize;
 		extern size_t gAdhocRatio;
+		extern size_t gPartitionThreadCount;
+		extern size_t gPartitionerType;
+		extern size_t gRetryPolicy;
 
 		const size_t kEventsNum = 2;
 		const size_t kMaxProcedureNum = 10;
@@ -23,6 +26,10 @@ namespace Cavalia{
 		enum LockType : size_t{ NO_LOCK, READ_LOCK, WRITE_LOCK, CERTIFY_LOCK };
 		//adding NO_CC versions for standard access types
 		enum AccessType : size_t { READ_ONLY, READ_WRITE, INSERT_ONLY, DELETE_ONLY, NO_CC_READ_ONLY, NO_CC_READ_WRITE, NO_CC_INSERT_ONLY, NO_CC_DELETE_ONLY};
+		//how the scheduler clusters the transactions of a super-batch
+		enum PartitionerType : size_t { GREEDY_PARTITIONER, MULTILEVEL_PARTITIONER, kPartitionerTypeSize };
+		//what a worker of ConcurrentExecutor does with a transaction that aborted
+		enum RetryPolicyType : size_t { SPIN_RETRY, BATCH_END_RETRY, DEADLINE_RETRY, SERIAL_LANE_RETRY, kRetryPolicyTypeSize };
 		const size_t kInsert = 0;
 		const size_t kUpdate = 1;
 		const size_t kDelete = 2;
@@ -0,0 +1,7 @@
+#include "BatchAnalyticsProfiler.h"
+
+namespace Cavalia{
+	namespace Database{
+		BatchAnalytics *batch_analytics_;
+	}
+}
@@ -0,0 +1,172 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_BATCH_ANALYTICS_PROFILER_H__
+#define __CAVALIA_DATABASE_BATCH_ANALYTICS_PROFILER_H__
+
+#include <cstdio>
+#include <vector>
+#include <TimeMeasurer.h>
+
+// file the per super-batch analytics are written to, in the working directory.
+#define BATCH_ANALYTICS_FILE "batch_analytics.csv"
+// clusters are counted in power-of-two buckets: 1, 2-3, 4-7, ..., the last one is open.
+#define BATCH_ANALYTICS_HISTOGRAM_SIZE 10
+
+namespace Cavalia{
+	namespace Database{
+		struct BatchAnalyticsRecord{
+			BatchAnalyticsRecord() : num_txns_(0), num_items_(0), num_contention_items_(0), num_accesses_(0), num_avoid_cc_accesses_(0), 
+				num_atomic_batches_(0), num_batched_txns_(0), max_atomic_batch_size_(0), cc_type_(0), partitioning_time_(0), completion_time_(0){
+				for (size_t i = 0; i < BATCH_ANALYTICS_HISTOGRAM_SIZE; ++i) cluster_histogram_[i] = 0;
+			}
+
+			void AddCluster(const size_t &size){
+				size_t bucket = 0;
+				while (bucket + 1 < BATCH_ANALYTICS_HISTOGRAM_SIZE && (size >> (bucket + 1)) != 0) ++bucket;
+				++cluster_histogram_[bucket];
+			}
+
+			size_t num_txns_;
+			size_t num_items_;
+			size_t num_contention_items_;
+			size_t cluster_histogram_[BATCH_ANALYTICS_HISTOGRAM_SIZE];
+			// accesses declared by the read-write sets, and those allowed to skip concurrency control.
+			size_t num_accesses_;
+			size_t num_avoid_cc_accesses_;
+			size_t num_atomic_batches_;
+			// transactions in atomic-batches, the others went to a dependency graph.
+			size_t num_batched_txns_;
+			size_t max_atomic_batch_size_;
+			size_t cc_type_;
+			long long partitioning_time_;
+			// nanoseconds since the first super-batch was published.
+			long long completion_time_;
+		};
+
+		/*
+		** Class BatchAnalytics:
+		** ---------------------
+		** Per super-batch record of what the scheduler decided, enabled by -DPROFILE_BATCH_ANALYTICS.
+		** The scheduler thread fills a record before publishing the super-batch, and whoever completes
+		** it stamps the completion time. The report writes one CSV row per super-batch, so that the
+		** partitioning of a super-batch can be lined up with how long it took to execute.
+		*/
+		class BatchAnalytics{
+		public:
+			BatchAnalytics() : records_(){
+				start_time_ = TimeMeasurer::GetTimePoint();
+			}
+
+			// scheduler thread, before any super-batch is published.
+			void Reserve(const size_t &num_batches){
+				records_.resize(num_batches);
+			}
+
+			BatchAnalyticsRecord& GetRecord(const int &batch_idx){
+				return records_[batch_idx];
+			}
+
+			// scheduler thread, once the workers may start.
+			void Start(){
+				start_time_ = TimeMeasurer::GetTimePoint();
+			}
+
+			void BeginPartitioning(){
+				partitioning_timer_.StartTimer();
+			}
+
+			void EndPartitioning(const int &batch_idx){
+				partitioning_timer_.EndTimer();
+				records_[batch_idx].partitioning_time_ = partitioning_timer_.GetElapsedNanoSeconds();
+			}
+
+			// super-batches complete in order.
+			void CompleteBatch(const int &batch_idx){
+				records_[batch_idx].completion_time_ = std::chrono::duration_cast<nanoseconds>(TimeMeasurer::GetTimePoint() - start_time_).count();
+			}
+
+			void Report(const char *file_name){
+				FILE *file = fopen(file_name, "w");
+				if (file == NULL){
+					printf("cannot open %s\n", file_name);
+					return;
+				}
+				fprintf(file, "batch_idx,num_txns,num_items,num_contention_items,avoid_cc_ratio,num_atomic_batches,atomic_batch_imbalance,cc_type,partitioning_time_us,execution_time_us");
+				for (size_t i = 0; i < BATCH_ANALYTICS_HISTOGRAM_SIZE; ++i){
+					fprintf(file, ",clusters_%lu", 1UL << i);
+				}
+				fprintf(file, "\n");
+				long long last_completion_time = 0;
+				for (size_t i = 0; i < records_.size(); ++i){
+					const BatchAnalyticsRecord &record = records_[i];
+					double avoid_cc_ratio = record.num_accesses_ == 0 ? 0.0 : record.num_avoid_cc_accesses_ * 1.0 / record.num_accesses_;
+					// largest atomic-batch over the average one, 1 is perfectly balanced.
+					double imbalance = record.num_atomic_batches_ == 0 ? 0.0 : record.max_atomic_batch_size_ * 1.0 * record.num_atomic_batches_ / record.num_batched_txns_;
+					// super-batches overlap with pipelined partitioning, execution is what elapsed since the previous one completed.
+					long long execution_time = record.completion_time_ == 0 ? 0 : record.completion_time_ - last_completion_time;
+					if (record.completion_time_ != 0){
+						last_completion_time = record.completion_time_;
+					}
+					fprintf(file, "%lu,%lu,%lu,%lu,%.4f,%lu,%.3f,%lu,%lld,%lld", i, record.num_txns_, record.num_items_, record.num_contention_items_, avoid_cc_ratio,
+						record.num_atomic_batches_, imbalance, record.cc_type_, record.partitioning_time_ / 1000, execution_time / 1000);
+					for (size_t j = 0; j < BATCH_ANALYTICS_HISTOGRAM_SIZE; ++j){
+						fprintf(file, ",%lu", record.cluster_histogram_[j]);
+					}
+					fprintf(file, "\n");
+				}
+				fclose(file);
+				printf("********************** BATCH ANALYTICS REPORT ************\n %lu super-batches written to %s\n", records_.size(), file_name);
+			}
+
+		private:
+			BatchAnalytics(const BatchAnalytics &);
+			BatchAnalytics& operator=(const BatchAnalytics &);
+
+		private:
+			std::vector<BatchAnalyticsRecord> records_;
+			system_clock::time_point start_time_;
+			TimeMeasurer partitioning_timer_;
+		};
+	}
+}
+
+#if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+#define INIT_BATCH_ANALYTICS_PROFILER \
+	batch_analytics_ = new BatchAnalytics();
+
+#define RESERVE_BATCH_ANALYTICS(num_batches) \
+	batch_analytics_->Reserve(num_batches);
+
+#define START_BATCH_ANALYTICS \
+	batch_analytics_->Start();
+
+#define BEGIN_BATCH_ANALYTICS_PARTITIONING_MEASURE \
+	batch_analytics_->BeginPartitioning();
+
+#define END_BATCH_ANALYTICS_PARTITIONING_MEASURE(batch_idx) \
+	batch_analytics_->EndPartitioning(batch_idx);
+
+#define COMPLETE_BATCH_ANALYTICS(batch_idx) \
+	batch_analytics_->CompleteBatch(batch_idx);
+
+#define REPORT_BATCH_ANALYTICS_PROFILER \
+	batch_analytics_->Report(BATCH_ANALYTICS_FILE); \
+	delete batch_analytics_; \
+	batch_analytics_ = NULL;
+
+#else
+#define INIT_BATCH_ANALYTICS_PROFILER ;
+#define RESERVE_BATCH_ANALYTICS(num_batches) ;
+#define START_BATCH_ANALYTICS ;
+#define BEGIN_BATCH_ANALYTICS_PARTITIONING_MEASURE ;
+#define END_BATCH_ANALYTICS_PARTITIONING_MEASURE(batch_idx) ;
+#define COMPLETE_BATCH_ANALYTICS(batch_idx) ;
+#define REPORT_BATCH_ANALYTICS_PROFILER ;
+#endif
+
+namespace Cavalia{
+	namespace Database{
+		extern BatchAnalytics *batch_analytics_;
+	}
+}
+
+#endif
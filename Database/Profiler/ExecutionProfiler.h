@@ -10,6 +10,19 @@
 #include <TimeMeasurer.h>
 #endif
 
+// transaction timings also train the cost model of the scheduler, even when profiling is muted.
+#if defined(COST_AWARE_PACKING)
+#include "../Scheduler/TxnCostModel.h"
+#define BEGIN_TRANSACTION_COST_MEASURE(thread_id) \
+	txn_cost_model_.BeginMeasure(thread_id);
+
+#define END_TRANSACTION_COST_MEASURE(thread_id, txn_type) \
+	txn_cost_model_.EndMeasure(thread_id, txn_type);
+#else
+#define BEGIN_TRANSACTION_COST_MEASURE(thread_id) ;
+#define END_TRANSACTION_COST_MEASURE(thread_id, txn_type) ;
+#endif
+
 #if !defined(MUTE) && defined(PROFILE_EXECUTION)
 #if defined(PRECISE_TIMER)
 #define INIT_EXECUTION_PROFILER \
@@ -23,10 +36,12 @@
 #endif
 
 #define BEGIN_TRANSACTION_TIME_MEASURE(thread_id) \
+	BEGIN_TRANSACTION_COST_MEASURE(thread_id); \
 	execution_timer_[thread_id].StartTimer();
 
 #define END_TRANSACTION_TIME_MEASURE(thread_id, txn_type) \
 	execution_timer_[thread_id].EndTimer(); \
+	END_TRANSACTION_COST_MEASURE(thread_id, txn_type); \
 if (execution_stat_[thread_id].find(txn_type) == execution_stat_[thread_id].end()){ \
 	execution_stat_[thread_id][txn_type] = execution_timer_[thread_id].GetElapsedNanoSeconds(); \
 } \
@@ -50,8 +65,8 @@ for (auto &entry : ordered_stat){ \
 
 #else
 #define INIT_EXECUTION_PROFILER ;
-#define BEGIN_TRANSACTION_TIME_MEASURE(thread_id) ;
-#define END_TRANSACTION_TIME_MEASURE(thread_id, txn_type) ;
+#define BEGIN_TRANSACTION_TIME_MEASURE(thread_id) BEGIN_TRANSACTION_COST_MEASURE(thread_id);
+#define END_TRANSACTION_TIME_MEASURE(thread_id, txn_type) END_TRANSACTION_COST_MEASURE(thread_id, txn_type);
 #define REPORT_EXECUTION_PROFILER ;
 #endif
 
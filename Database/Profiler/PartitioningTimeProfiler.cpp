@@ -3,10 +3,14 @@
 namespace Cavalia{
 	namespace Database{
 		long long* access_partitioning_stat_;
+		long long* access_partitioning_hidden_stat_;
+		long long* access_partitioning_stall_stat_;
 #if defined(PRECISE_TIMER)
 		PreciseTimeMeasurer *access_partitioning_timer_;
+		PreciseTimeMeasurer *access_partitioning_stall_timer_;
 #else
 		TimeMeasurer *access_partitioning_timer_;
+		TimeMeasurer *access_partitioning_stall_timer_;
 #endif
 	}
 }
@@ -13,13 +13,23 @@
 #if defined(PRECISE_TIMER) 
 #define INIT_PARTITIONING_TIME_PROFILER \
 	access_partitioning_stat_ = new long long[kMaxThreadNum]; \
+	access_partitioning_hidden_stat_ = new long long[kMaxThreadNum]; \
+	access_partitioning_stall_stat_ = new long long[kMaxThreadNum]; \
 	for(size_t i = 0; i < kMaxThreadNum; ++i) access_partitioning_stat_[i] = 0; \
-	access_partitioning_timer_ = new PreciseTimeMeasurer[kMaxThreadNum];
+	for(size_t i = 0; i < kMaxThreadNum; ++i) access_partitioning_hidden_stat_[i] = 0; \
+	for(size_t i = 0; i < kMaxThreadNum; ++i) access_partitioning_stall_stat_[i] = 0; \
+	access_partitioning_timer_ = new PreciseTimeMeasurer[kMaxThreadNum]; \
+	access_partitioning_stall_timer_ = new PreciseTimeMeasurer[kMaxThreadNum];
 #else
 #define INIT_PARTITIONING_TIME_PROFILER \
 	access_partitioning_stat_ = new long long[kMaxThreadNum]; \
-	memset(access_partitioning_stat_, 0, sizeof(access_partitioning_stat_)*kMaxThreadNum); \
-	access_partitioning_timer_ = new TimeMeasurer[kMaxThreadNum];
+	access_partitioning_hidden_stat_ = new long long[kMaxThreadNum]; \
+	access_partitioning_stall_stat_ = new long long[kMaxThreadNum]; \
+	memset(access_partitioning_stat_, 0, sizeof(long long)*kMaxThreadNum); \
+	memset(access_partitioning_hidden_stat_, 0, sizeof(long long)*kMaxThreadNum); \
+	memset(access_partitioning_stall_stat_, 0, sizeof(long long)*kMaxThreadNum); \
+	access_partitioning_timer_ = new TimeMeasurer[kMaxThreadNum]; \
+	access_partitioning_stall_timer_ = new TimeMeasurer[kMaxThreadNum];
 #endif
 #define BEGIN_PARTITIONING_TIME_MEASURE(thread_id) \
 	access_partitioning_timer_[thread_id].StartTimer();
@@ -28,29 +38,64 @@
 	access_partitioning_timer_[thread_id].EndTimer(); \
 	access_partitioning_stat_[thread_id] += access_partitioning_timer_[thread_id].GetElapsedNanoSeconds();
 
+// partitioning that ran while workers were executing an earlier super-batch.
+#define END_HIDDEN_PARTITIONING_TIME_MEASURE(thread_id) \
+	access_partitioning_timer_[thread_id].EndTimer(); \
+	access_partitioning_stat_[thread_id] += access_partitioning_timer_[thread_id].GetElapsedNanoSeconds(); \
+	access_partitioning_hidden_stat_[thread_id] += access_partitioning_timer_[thread_id].GetElapsedNanoSeconds();
+
+// time a worker spends waiting for the partitioner to publish the next super-batch.
+#define BEGIN_PARTITIONING_STALL_TIME_MEASURE(thread_id) \
+	access_partitioning_stall_timer_[thread_id].StartTimer();
+
+#define END_PARTITIONING_STALL_TIME_MEASURE(thread_id) \
+	access_partitioning_stall_timer_[thread_id].EndTimer(); \
+	access_partitioning_stall_stat_[thread_id] += access_partitioning_stall_timer_[thread_id].GetElapsedNanoSeconds();
+
 #define REPORT_PARTITIONING_TIME_PROFILER \
-	long long partitioning_res = 0; \
+	long long partitioning_res = 0, partitioning_overlap_res = 0, partitioning_stall_res = 0; \
+	size_t partitioning_stall_threads = 0; \
 	for (size_t i = 0; i < kMaxThreadNum; ++i) partitioning_res += access_partitioning_stat_[i]; \
+	for (size_t i = 0; i < kMaxThreadNum; ++i) partitioning_overlap_res += access_partitioning_hidden_stat_[i]; \
+	for (size_t i = 0; i < kMaxThreadNum; ++i) { \
+		if (access_partitioning_stall_stat_[i] != 0) { partitioning_stall_res += access_partitioning_stall_stat_[i]; ++partitioning_stall_threads; } \
+	} \
+	if (partitioning_stall_threads != 0) partitioning_stall_res /= partitioning_stall_threads; \
 	printf("********************** PARTITIONING TIME REPORT ************\n in total, partitioning time=%lld ms\n", partitioning_res / 1000 / 1000); \
+	printf(" overlapped with execution=%lld ms, average worker stall=%lld ms, hidden=%lld ms\n", partitioning_overlap_res / 1000 / 1000, partitioning_stall_res / 1000 / 1000, \
+		(partitioning_overlap_res > partitioning_stall_res ? partitioning_overlap_res - partitioning_stall_res : 0) / 1000 / 1000); \
 	delete[] access_partitioning_timer_; \
 	access_partitioning_timer_ = NULL; \
+	delete[] access_partitioning_stall_timer_; \
+	access_partitioning_stall_timer_ = NULL; \
 	delete[] access_partitioning_stat_; \
-	access_partitioning_stat_ = NULL;
+	access_partitioning_stat_ = NULL; \
+	delete[] access_partitioning_hidden_stat_; \
+	access_partitioning_hidden_stat_ = NULL; \
+	delete[] access_partitioning_stall_stat_; \
+	access_partitioning_stall_stat_ = NULL;
 
 #else
 #define INIT_PARTITIONING_TIME_PROFILER ;
 #define BEGIN_PARTITIONING_TIME_MEASURE(thread_id) ;
 #define END_PARTITIONING_TIME_MEASURE(thread_id) ;
+#define END_HIDDEN_PARTITIONING_TIME_MEASURE(thread_id) ;
+#define BEGIN_PARTITIONING_STALL_TIME_MEASURE(thread_id) ;
+#define END_PARTITIONING_STALL_TIME_MEASURE(thread_id) ;
 #define REPORT_PARTITIONING_TIME_PROFILER ;
 #endif
 
 namespace Cavalia{
 	namespace Database{
 		extern long long* access_partitioning_stat_;
+		extern long long* access_partitioning_hidden_stat_;
+		extern long long* access_partitioning_stall_stat_;
 #if defined(PRECISE_TIMER)
 		extern PreciseTimeMeasurer *access_partitioning_timer_;
+		extern PreciseTimeMeasurer *access_partitioning_stall_timer_;
 #else
 		extern TimeMeasurer *access_partitioning_timer_;
+		extern TimeMeasurer *access_partitioning_stall_timer_;
 #endif
 	}
 }
@@ -13,6 +13,8 @@
 #include "CCMemAllocTimeProfiler.h"
 #include "IndexTimeProfiler.h"
 #include "CCWaitCountProfiler.h"
+#include "BatchAnalyticsProfiler.h"
+#include "VersionGcProfiler.h"
 
 #if defined(MUTE)
 #define INIT_PROFILERS ;
@@ -33,7 +35,9 @@
 	INIT_CC_MEM_ALLOC_TIME_PROFILER;\
 	INIT_INDEX_TIME_PROFILER;\
 	INIT_BATCH_SYNC_TIME_PROFILER;\
-	INIT_PARTITIONING_TIME_PROFILER;
+	INIT_PARTITIONING_TIME_PROFILER;\
+	INIT_BATCH_ANALYTICS_PROFILER;\
+	INIT_VERSION_GC_PROFILER;
 
 #define REPORT_PROFILERS\
 	REPORT_EXECUTION_PROFILER;\
@@ -48,7 +52,9 @@
 	REPORT_CC_MEM_ALLOC_TIME_PROFILER;\
 	REPORT_INDEX_TIME_PROFILER;\
 	REPORT_BATCH_SYNC_TIME_PROFILER;\
-	REPORT_PARTITIONING_TIME_PROFILER;
+	REPORT_PARTITIONING_TIME_PROFILER;\
+	REPORT_BATCH_ANALYTICS_PROFILER;\
+	REPORT_VERSION_GC_PROFILER;
 #endif
 
 #endif
@@ -0,0 +1,7 @@
+#include "VersionGcProfiler.h"
+
+namespace Cavalia{
+	namespace Database{
+		VersionGcProfile *version_gc_profile_ = NULL;
+	}
+}
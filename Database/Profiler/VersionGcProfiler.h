@@ -0,0 +1,109 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_VERSION_GC_PROFILER_H__
+#define __CAVALIA_DATABASE_VERSION_GC_PROFILER_H__
+
+#include <cstdio>
+#include <vector>
+#include <mutex>
+#include <TimeMeasurer.h>
+
+// file the version garbage collection samples are written to, in the working directory.
+#define VERSION_GC_FILE "version_gc.csv"
+// period at which Watermark samples the garbage collector, in microseconds.
+#define VERSION_GC_SAMPLE_INTERVAL 10000
+
+namespace Cavalia{
+	namespace Database{
+		struct VersionGcSample{
+			long long elapsed_time_;
+			// versions installed and not freed yet, including the current ones.
+			size_t live_versions_;
+			size_t retired_versions_;
+			size_t pending_bytes_;
+			double avg_chain_length_;
+			size_t max_chain_length_;
+		};
+
+		/*
+		** Class VersionGcProfile:
+		** -----------------------
+		** Memory held by multi-version histories over time, enabled by -DPROFILE_VERSION_GC. Watermark
+		** takes a sample of the GarbageCollector counters every VERSION_GC_SAMPLE_INTERVAL microseconds
+		** and the report writes one CSV row per sample.
+		*/
+		class VersionGcProfile{
+		public:
+			VersionGcProfile() : samples_(){
+				start_time_ = TimeMeasurer::GetTimePoint();
+			}
+
+			// Watermark thread only.
+			void AddSample(const size_t &installed_count, const size_t &retired_count, const size_t &freed_count, const size_t &pending_bytes, const size_t &chain_length_sum, const size_t &max_chain_length){
+				VersionGcSample sample;
+				sample.elapsed_time_ = std::chrono::duration_cast<nanoseconds>(TimeMeasurer::GetTimePoint() - start_time_).count();
+				sample.live_versions_ = installed_count - freed_count;
+				sample.retired_versions_ = retired_count - freed_count;
+				sample.pending_bytes_ = pending_bytes;
+				sample.avg_chain_length_ = installed_count == 0 ? 0.0 : chain_length_sum * 1.0 / installed_count;
+				sample.max_chain_length_ = max_chain_length;
+				std::lock_guard<std::mutex> guard(mutex_);
+				samples_.push_back(sample);
+			}
+
+			void Report(const char *file_name){
+				std::lock_guard<std::mutex> guard(mutex_);
+				FILE *file = fopen(file_name, "w");
+				if (file == NULL){
+					printf("cannot open %s\n", file_name);
+					return;
+				}
+				fprintf(file, "elapsed_ms,live_versions,retired_versions,pending_bytes,avg_chain_length,max_chain_length\n");
+				for (size_t i = 0; i < samples_.size(); ++i){
+					const VersionGcSample &sample = samples_[i];
+					fprintf(file, "%lld,%lu,%lu,%lu,%.3f,%lu\n", sample.elapsed_time_ / 1000000, sample.live_versions_, sample.retired_versions_,
+						sample.pending_bytes_, sample.avg_chain_length_, sample.max_chain_length_);
+				}
+				fclose(file);
+				printf("********************** VERSION GC REPORT ************\n %lu samples written to %s\n", samples_.size(), file_name);
+			}
+
+		private:
+			VersionGcProfile(const VersionGcProfile &);
+			VersionGcProfile& operator=(const VersionGcProfile &);
+
+		private:
+			// Watermark keeps sampling while the report is written.
+			std::mutex mutex_;
+			std::vector<VersionGcSample> samples_;
+			system_clock::time_point start_time_;
+		};
+	}
+}
+
+#if !defined(MUTE) && defined(PROFILE_VERSION_GC)
+#define INIT_VERSION_GC_PROFILER \
+	version_gc_profile_ = new VersionGcProfile();
+
+#define SAMPLE_VERSION_GC(statistics) \
+	if (version_gc_profile_ != NULL){ \
+		version_gc_profile_->AddSample(statistics.installed_count_, statistics.retired_count_, statistics.freed_count_, \
+			statistics.pending_bytes_, statistics.chain_length_sum_, statistics.max_chain_length_); \
+	}
+
+// not deleted, Watermark may still hold it.
+#define REPORT_VERSION_GC_PROFILER \
+	version_gc_profile_->Report(VERSION_GC_FILE);
+
+#else
+#define INIT_VERSION_GC_PROFILER ;
+#define SAMPLE_VERSION_GC(statistics) ;
+#define REPORT_VERSION_GC_PROFILER ;
+#endif
+
+namespace Cavalia{
+	namespace Database{
+		extern VersionGcProfile *version_gc_profile_;
+	}
+}
+
+#endif
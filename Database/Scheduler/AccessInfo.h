@@ -4,41 +4,280 @@
 
 #include <vector>
 #include <atomic>
-#include <unordered_map>
 #include <unordered_set>
 #include <iostream>
+#include <cstring>
+#include <new>
+#include <BumpArena.h>
 #include "../Transaction/TxnParam.h"
 namespace Cavalia{
 	namespace Database{
         class ConcurrentExecutor;
 
+		//Open-addressing set of transactions with linear probing. Slots are taken
+		//from the arena of the super-batch, so the set is never freed on its own.
+		struct TxnSet
+		{
+			TxnParam** slots_;
+			size_t capacity_; //zero or a power of two
+			size_t size_;
+			BumpArena* arena_;
+
+			struct iterator
+			{
+				TxnParam** slot_;
+				TxnParam** end_;
+				iterator(TxnParam** slot, TxnParam** end) : slot_(slot), end_(end) { SkipEmpty(); }
+				inline TxnParam* operator*() const { return *slot_; }
+				inline iterator& operator++() { slot_++; SkipEmpty(); return *this; }
+				inline iterator operator++(int) { iterator ret = *this; ++(*this); return ret; }
+				inline bool operator==(const iterator& other) const { return slot_ == other.slot_; }
+				inline bool operator!=(const iterator& other) const { return slot_ != other.slot_; }
+				inline void SkipEmpty() { while(slot_ != end_ && *slot_ == NULL) slot_++; }
+			};
+
+			TxnSet(BumpArena* arena) : slots_(NULL), capacity_(0), size_(0), arena_(arena) {}
+
+			inline size_t size() const { return size_; }
+			inline iterator begin() const { return iterator(slots_, slots_ + capacity_); }
+			inline iterator end() const { return iterator(slots_ + capacity_, slots_ + capacity_); }
+
+			inline void insert(TxnParam* txn) {
+				if((size_ + 1) * 4 > capacity_ * 3) {
+					Grow();
+				}
+				size_t slot = FindSlot(txn);
+				if(slots_[slot] == NULL) {
+					slots_[slot] = txn;
+					size_++;
+				}
+			}
+
+			template<class Iterator>
+			inline void insert(Iterator first, Iterator last) {
+				for(; first != last; first++) {
+					insert(*first);
+				}
+			}
+
+			//backward-shift deletion, so that no tombstones are needed
+			inline void erase(TxnParam* txn) {
+				if(capacity_ == 0) {
+					return;
+				}
+				size_t mask = capacity_ - 1;
+				size_t hole = FindSlot(txn);
+				if(slots_[hole] == NULL) {
+					return;
+				}
+				slots_[hole] = NULL;
+				size_--;
+				for(size_t slot = (hole + 1) & mask; slots_[slot] != NULL; slot = (slot + 1) & mask) {
+					size_t home = Hash(slots_[slot]) & mask;
+					//move the entry into the hole unless its home lies cyclically in (hole, slot]
+					if(((slot - home) & mask) >= ((slot - hole) & mask)) {
+						slots_[hole] = slots_[slot];
+						slots_[slot] = NULL;
+						hole = slot;
+					}
+				}
+			}
+
+			static inline size_t Hash(TxnParam* txn) {
+				uint64_t h = (uint64_t)(uintptr_t)txn * 0x9E3779B97F4A7C15ULL;
+				return (size_t)(h ^ (h >> 32));
+			}
+
+			//slot holding txn, or the empty slot where it would go
+			inline size_t FindSlot(TxnParam* txn) const {
+				size_t mask = capacity_ - 1;
+				size_t slot = Hash(txn) & mask;
+				while(slots_[slot] != NULL && slots_[slot] != txn) {
+					slot = (slot + 1) & mask;
+				}
+				return slot;
+			}
+
+			void Grow() {
+				TxnParam** old_slots = slots_;
+				size_t old_capacity = capacity_;
+				capacity_ = old_capacity == 0 ? 4 : old_capacity * 2;
+				slots_ = (TxnParam**)arena_->Alloc(capacity_ * sizeof(TxnParam*));
+				memset(slots_, 0, capacity_ * sizeof(TxnParam*));
+				//the old slots stay in the arena until the super-batch retires
+				for(size_t i = 0; i < old_capacity; i++) {
+					if(old_slots[i] != NULL) {
+						slots_[FindSlot(old_slots[i])] = old_slots[i];
+					}
+				}
+			}
+		};
+
 		//This object contains information about each data item in current batch
 		struct BatchAccessInfo
 		{
 			int64_t hash_; //data hash
 			bool has_writes_; //for optimizations
 			bool avoid_cc_;
-			std::unordered_set<TxnParam*> txns_; //txn clusters in current batch that access data
-			BatchAccessInfo(int64_t hash) : txns_(), hash_(hash), has_writes_(false), avoid_cc_(false) {}
+			int owner_thread_; //worker the item was placed on, -1 if none
+			TxnSet txns_; //txn clusters in current batch that access data
+			BatchAccessInfo(int64_t hash, BumpArena* arena) : txns_(arena), hash_(hash), has_writes_(false), avoid_cc_(false), owner_thread_(-1) {}
 			inline void AddTransaction(TxnParam* txn) { txns_.insert(txn); }
 			inline void RemoveTransaction(TxnParam* txn) { txns_.erase(txn); }
 		};
 
+		//Data hash of the record with key in table_id, for benchmarks whose keys are
+		//not plain integers. FNV-1a seeded with the table id; a collision merely puts
+		//two records in the same BatchAccessInfo, which is conservative.
+		inline int64_t GetRecordHash(const size_t& table_id, const char* key, const size_t& key_size) {
+			uint64_t h = 14695981039346656037ULL ^ (uint64_t)table_id;
+			h *= 1099511628211ULL;
+			for(size_t i = 0; i < key_size; i++) {
+				h ^= (unsigned char)key[i];
+				h *= 1099511628211ULL;
+			}
+			return (int64_t)h;
+		}
+
+		//Open-addressing map from data hash to BatchAccessInfo, used both for the
+		//whole super-batch and for the read-write set of a single transaction.
+		//Entries and the infos created by GetOrAdd live in the arena the set is
+		//bound to, so a super-batch is released by resetting its arenas.
 		struct ReadWriteSet 
 		{
-			std::unordered_map<int64_t, BatchAccessInfo*> lookup_;
-			ReadWriteSet() : lookup_() {}
-			inline bool CanAvoidConcurrencyControl(int64_t hash) { return lookup_[hash] == NULL? false : lookup_[hash]->avoid_cc_; }	
-			inline BatchAccessInfo* Get(int64_t hash) { return lookup_[hash]; }
-			inline void Add(int64_t hash, BatchAccessInfo* info) { lookup_[hash] = info; }
+			struct Entry
+			{
+				int64_t hash_;
+				BatchAccessInfo* info_; //NULL marks an empty entry
+			};
+
+			struct iterator
+			{
+				Entry* entry_;
+				Entry* end_;
+				iterator(Entry* entry, Entry* end) : entry_(entry), end_(end) { SkipEmpty(); }
+				inline Entry& operator*() const { return *entry_; }
+				inline Entry* operator->() const { return entry_; }
+				inline iterator& operator++() { entry_++; SkipEmpty(); return *this; }
+				inline iterator operator++(int) { iterator ret = *this; ++(*this); return ret; }
+				inline bool operator==(const iterator& other) const { return entry_ == other.entry_; }
+				inline bool operator!=(const iterator& other) const { return entry_ != other.entry_; }
+				inline void SkipEmpty() { while(entry_ != end_ && entry_->info_ == NULL) entry_++; }
+			};
+
+			Entry* entries_;
+			size_t capacity_; //zero or a power of two
+			size_t size_;
+			BumpArena* arena_;
+
+			ReadWriteSet() : entries_(NULL), capacity_(0), size_(0), arena_(NULL) {}
+
+			//empties the set and binds it to arena. O(1), the old entries are left to the old arena.
+			inline void Reset(BumpArena* arena) {
+				entries_ = NULL;
+				capacity_ = 0;
+				size_ = 0;
+				arena_ = arena;
+			}
+			inline BumpArena* GetArena() const { return arena_; }
+
+			inline size_t size() const { return size_; }
+			inline iterator begin() const { return iterator(entries_, entries_ + capacity_); }
+			inline iterator end() const { return iterator(entries_ + capacity_, entries_ + capacity_); }
+
+			inline bool CanAvoidConcurrencyControl(int64_t hash) const { 
+				BatchAccessInfo* info = Get(hash);
+				return info == NULL ? false : info->avoid_cc_; 
+			}
+			inline BatchAccessInfo* Get(int64_t hash) const {
+				if(capacity_ == 0) {
+					return NULL;
+				}
+				return entries_[FindSlot(hash)].info_;
+			}
+			inline void Add(int64_t hash, BatchAccessInfo* info) {
+				assert(info != NULL);
+				Entry& entry = Insert(hash);
+				entry.info_ = info;
+			}
+			//declares an access of txn to hash in its own set and in the set of its super-batch
+			inline void AddAccess(ReadWriteSet& batch_rw_set, TxnParam* txn, int64_t hash, bool is_write) {
+				BatchAccessInfo* info = batch_rw_set.GetOrAdd(hash);
+				Add(hash, info);
+				info->AddTransaction(txn);
+				if(is_write) {
+					info->has_writes_ = true;
+				}
+			}
 			inline BatchAccessInfo* GetOrAdd(int64_t hash) {
-				auto info = lookup_[hash];
-				if(info == NULL) {
-					info = new BatchAccessInfo(hash);
-					lookup_[hash] = info;
+				Entry& entry = Insert(hash);
+				if(entry.info_ == NULL) {
+					entry.info_ = new (arena_->Alloc(sizeof(BatchAccessInfo))) BatchAccessInfo(hash, arena_);
 				}
-				return info;
+				return entry.info_;
 			}
+
+			static inline size_t Hash(int64_t hash) {
+				uint64_t h = (uint64_t)hash * 0x9E3779B97F4A7C15ULL;
+				return (size_t)(h ^ (h >> 32));
+			}
+
+			//entry holding hash, or the empty entry where it would go
+			inline size_t FindSlot(int64_t hash) const {
+				size_t mask = capacity_ - 1;
+				size_t slot = Hash(hash) & mask;
+				while(entries_[slot].info_ != NULL && entries_[slot].hash_ != hash) {
+					slot = (slot + 1) & mask;
+				}
+				return slot;
+			}
+
+			//returns the entry of hash, claiming an empty one if needed. The caller
+			//must fill info_ of a claimed entry.
+			inline Entry& Insert(int64_t hash) {
+				if((size_ + 1) * 4 > capacity_ * 3) {
+					Grow();
+				}
+				Entry& entry = entries_[FindSlot(hash)];
+				if(entry.info_ == NULL) {
+					entry.hash_ = hash;
+					size_++;
+				}
+				return entry;
+			}
+
+			void Grow() {
+				assert(arena_ != NULL);
+				Entry* old_entries = entries_;
+				size_t old_capacity = capacity_;
+				capacity_ = old_capacity == 0 ? 8 : old_capacity * 2;
+				entries_ = (Entry*)arena_->Alloc(capacity_ * sizeof(Entry));
+				memset(entries_, 0, capacity_ * sizeof(Entry));
+				for(size_t i = 0; i < old_capacity; i++) {
+					if(old_entries[i].info_ != NULL) {
+						entries_[FindSlot(old_entries[i].hash_)] = old_entries[i];
+					}
+				}
+			}
+		};
+
+		//Transactions that have to execute in the same atomic-batch. Members
+		//point into an array that holds all transactions of the super-batch.
+		struct TxnCluster
+		{
+			TxnParam** members_;
+			size_t size_;
+			TxnCluster(TxnParam** members, size_t size) : members_(members), size_(size) {}
+		};
+
+		//Statistics gathered while clustering a super-batch
+		struct PartitionStatistics
+		{
+			size_t num_txns_;
+			size_t num_items_;
+			size_t num_contention_items_;
+			size_t total_contention_; //sum of the cluster sizes that contended items would have needed
+			PartitionStatistics() : num_txns_(0), num_items_(0), num_contention_items_(0), total_contention_(0) {}
 		};
 
 		
@@ -60,10 +299,10 @@ namespace Cavalia{
 				//TxnParam could either be a cluster or a single transaction
 				if(txn->data_ == NULL) {
 					//single transaction
-					auto rw_set = txn->GetReadWriteSet();
-					auto iter = rw_set.lookup_.begin();
-					for(; iter != rw_set.lookup_.end(); iter++) {
-						BatchAccessInfo* info = iter->second;
+					ReadWriteSet& rw_set = txn->GetReadWriteSet();
+					auto iter = rw_set.begin();
+					for(; iter != rw_set.end(); iter++) {
+						BatchAccessInfo* info = iter->info_;
 						items_accessed_.insert(info);
 					}
 				} 
@@ -79,10 +318,10 @@ namespace Cavalia{
 			inline void ReplaceInNeighbors(TxnParam* other) {
 				if(other->data_ == NULL) {
 					//single transaction
-					auto rw_set = other->GetReadWriteSet();
-					auto iter = rw_set.lookup_.begin();
-					for(; iter != rw_set.lookup_.end(); iter++) {
-						BatchAccessInfo* info = iter->second;
+					ReadWriteSet& rw_set = other->GetReadWriteSet();
+					auto iter = rw_set.begin();
+					for(; iter != rw_set.end(); iter++) {
+						BatchAccessInfo* info = iter->info_;
 						info->RemoveTransaction(other);
 						info->AddTransaction(owner_); //set semantics, don't worry!
 					}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_BASE_PARTITIONER_H__
+#define __CAVALIA_DATABASE_BASE_PARTITIONER_H__
+
+#include <vector>
+#include <cassert>
+#include "../Meta/MetaTypes.h"
+#include "../Transaction/TxnParam.h"
+#include "AccessInfo.h"
+#if defined(RECONNAISSANCE)
+#include "Reconnaissance.h"
+#endif
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Class BasePartitioner:
+        ** ----------------------
+        ** Clusters the transactions of a super-batch for SharedWorklistScheduler::DoDataBasedPartition.
+        ** A partitioner builds the read-write set of every transaction, sets avoid_cc_ on the items whose
+        ** transactions all end up in the same cluster, and returns clusters small enough for an
+        ** atomic-batch. The scheduler picks one at startup from gPartitionerType; the greedy merge by
+        ** item degree runs in the scheduler itself unless -DPARALLEL_PARTITIONING is set.
+        */
+        class BasePartitioner {
+        public:
+            BasePartitioner() {
+            #if defined(RECONNAISSANCE)
+                reconnaissances_ = NULL;
+            #endif
+            }
+            virtual ~BasePartitioner() {}
+
+            virtual void Start() {}
+            virtual void Stop() {}
+            //clusters txns. clustered_txns must have room for txns.size() entries. arenas holds one
+            //arena per partitioning thread, which keeps the read-write sets until the super-batch retires.
+            virtual void Cluster(std::vector<TxnParam*>& txns, BumpArena** arenas, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats) = 0;
+#if defined(RECONNAISSANCE)
+            //one per partitioning thread, must be set before Start
+            void SetReconnaissances(Reconnaissance** reconnaissances) {
+                reconnaissances_ = reconnaissances;
+            }
+#endif
+
+        protected:
+            void BuildReadWriteSet(const size_t& thread_id, TxnParam* txn, ReadWriteSet& batch_rw_set) {
+            #if defined(RECONNAISSANCE)
+                reconnaissances_[thread_id]->BuildReadWriteSet(txn, batch_rw_set);
+            #else
+                if(!txn->BuildReadWriteSet(batch_rw_set)) {
+                    //the items of txn are only found by a reconnaissance run
+                    assert(false);
+                }
+            #endif
+            }
+
+        private:
+            BasePartitioner(const BasePartitioner&);
+            BasePartitioner& operator=(const BasePartitioner&);
+
+        protected:
+#if defined(RECONNAISSANCE)
+            Reconnaissance** reconnaissances_;
+#endif
+        };
+	}
+}
+
+#endif
@@ -18,6 +18,13 @@ namespace Cavalia{
 			virtual void Initialize(const size_t& thread_id) = 0;
             virtual ParamBatch* GetNextBatch(const size_t& thread_id) = 0;
 			virtual void ThreadRun() = 0;
+			// takes txn off the atomic-batch it failed in, only schedulers with a barrier support it.
+			virtual void DeferTransaction(const size_t& thread_id, TxnParam* txn) {
+				assert(false);
+			}
+			virtual bool CanDeferTransaction() const {
+				return false;
+			}
 		private:
 			BaseScheduler(const BaseScheduler &);
 			BaseScheduler& operator=(const BaseScheduler &);
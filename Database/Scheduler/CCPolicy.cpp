@@ -0,0 +1,58 @@
+#include "CCPolicy.h"
+
+namespace Cavalia{
+	namespace Database{
+		CCFeedback cc_feedback_;
+
+		const double AdaptiveCCPolicy::kSmoothingFactor = 0.5;
+
+		void AdaptiveCCPolicy::Observe() {
+			size_t completed_count = cc_feedback_.GetCompletedCount();
+			for(; next_outcome_idx_ < completed_count; next_outcome_idx_++) {
+				const CCBatchOutcome& outcome = cc_feedback_.GetOutcome(next_outcome_idx_);
+				if(outcome.execution_time_ == 0) {
+					continue;
+				}
+				double throughput = outcome.commit_count_ * 1000000000.0 / outcome.execution_time_;
+				double& estimate = throughputs_[outcome.contention_level_][outcome.cc_type_];
+				size_t& observed_count = observed_counts_[outcome.contention_level_][outcome.cc_type_];
+				estimate = observed_count == 0 ? throughput : kSmoothingFactor * throughput + (1 - kSmoothingFactor) * estimate;
+				observed_count++;
+			}
+		}
+
+		ConcurrencyControlType AdaptiveCCPolicy::Select(const int& batch_idx, const PartitionStatistics& stats) {
+			//the first candidate is also what ContentionThresholdCCPolicy would pick
+			static const ConcurrencyControlType low_candidates[kCCTypeNum] = { CC_OCC, CC_SILO, CC_LOCK_WAIT, CC_LOCK_NO_WAIT };
+			static const ConcurrencyControlType high_candidates[kCCTypeNum] = { CC_LOCK_WAIT, CC_LOCK_NO_WAIT, CC_OCC, CC_SILO };
+			Observe();
+			size_t level = CCFeedback::GetContentionLevel(stats);
+			const ConcurrencyControlType* candidates = level == 2 ? high_candidates : low_candidates;
+			size_t decision_count = decision_counts_[level]++;
+
+			ConcurrencyControlType type = candidates[0];
+			long long least_recent = batch_idx;
+			double best_throughput = -1.0;
+			bool is_exploring = decision_count % kExplorePeriod == kExplorePeriod - 1;
+			for(size_t i = 0; i < kCCTypeNum; i++) {
+				ConcurrencyControlType candidate = candidates[i];
+				if(last_tried_[level][candidate] < 0) {
+					//never tried at this level
+					type = candidate;
+					break;
+				}
+				if(is_exploring) {
+					if(last_tried_[level][candidate] < least_recent) {
+						least_recent = last_tried_[level][candidate];
+						type = candidate;
+					}
+				} else if(observed_counts_[level][candidate] > 0 && throughputs_[level][candidate] > best_throughput) {
+					best_throughput = throughputs_[level][candidate];
+					type = candidate;
+				}
+			}
+			last_tried_[level][type] = batch_idx;
+			return type;
+		}
+	}
+}
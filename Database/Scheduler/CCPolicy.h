@@ -0,0 +1,239 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_CC_POLICY_H__
+#define __CAVALIA_DATABASE_CC_POLICY_H__
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <boost/smart_ptr/detail/spinlock.hpp>
+#if defined(PRECISE_TIMER)
+#include <PreciseTimeMeasurer.h>
+#else
+#include <TimeMeasurer.h>
+#endif
+#include "../Meta/MetaTypes.h"
+#include "../Transaction/TxnContext.h"
+#include "AccessInfo.h"
+
+namespace Cavalia{
+	namespace Database{
+        const size_t kCCTypeNum = CC_SILO + 1;
+        //no contended item, few and lightly contended items, the rest
+        const size_t kContentionLevelNum = 3;
+
+        //decision taken for a super-batch and what executing it under that protocol gave
+        struct CCBatchOutcome
+        {
+            ConcurrencyControlType cc_type_;
+            size_t contention_level_;
+            double contention_ratio_;
+            double average_contention_;
+            uint64_t commit_count_;
+            uint64_t abort_count_;
+            //nanoseconds, summed over the workers
+            uint64_t execution_time_;
+
+            CCBatchOutcome() : cc_type_(CC_LOCK_WAIT), contention_level_(0), contention_ratio_(0.0), average_contention_(0.0), commit_count_(0), abort_count_(0), execution_time_(0) {}
+        };
+
+        /*
+        ** Class CCFeedback:
+        ** -----------------
+        ** Collects what the protocols chosen under -DDYNAMIC_CC achieve. Workers time every batch they
+        ** execute and add its commits and aborts, retries included, to per-thread counters. Whoever
+        ** completes a super-batch folds the counters into the outcome of that super-batch, so every
+        ** super-batch is charged for the work done since the previous one completed. Like the cost
+        ** model, this runs regardless of MUTE since the scheduler learns from it.
+        */
+        class CCFeedback {
+        public:
+            CCFeedback() : outcomes_(), completed_count_(0) {
+                for(size_t i = 0; i < kMaxThreadNum; i++) {
+                    thread_counts_[i].commit_count_.store(0, std::memory_order_relaxed);
+                    thread_counts_[i].abort_count_.store(0, std::memory_order_relaxed);
+                    thread_counts_[i].execution_time_.store(0, std::memory_order_relaxed);
+                }
+                memset(&lock_, 0, sizeof(lock_));
+            }
+
+            //scheduler thread, before any super-batch is published
+            void Reserve(const size_t& num_batches) {
+                outcomes_.resize(num_batches);
+            }
+
+            void BeginBatch(const size_t& thread_id) {
+                thread_counts_[thread_id].timer_.StartTimer();
+            }
+
+            void EndBatch(const size_t& thread_id, const uint64_t& commit_count, const uint64_t& abort_count) {
+                ThreadCount& thread_count = thread_counts_[thread_id];
+                thread_count.timer_.EndTimer();
+                //single writer, readers fold under lock_
+                thread_count.commit_count_.store(thread_count.commit_count_.load(std::memory_order_relaxed) + commit_count, std::memory_order_relaxed);
+                thread_count.abort_count_.store(thread_count.abort_count_.load(std::memory_order_relaxed) + abort_count, std::memory_order_relaxed);
+                thread_count.execution_time_.store(thread_count.execution_time_.load(std::memory_order_relaxed) + thread_count.timer_.GetElapsedNanoSeconds(), std::memory_order_relaxed);
+            }
+
+            //scheduler thread, before the super-batch is published
+            void RecordDecision(const int& batch_idx, const ConcurrencyControlType& type, const PartitionStatistics& stats) {
+                CCBatchOutcome& outcome = outcomes_[batch_idx];
+                outcome.cc_type_ = type;
+                outcome.contention_level_ = GetContentionLevel(stats);
+                outcome.contention_ratio_ = GetContentionRatio(stats);
+                outcome.average_contention_ = GetAverageContention(stats);
+            }
+
+            //super-batches complete in order
+            void CompleteBatch(const int& batch_idx) {
+                lock_.lock();
+                uint64_t commit_count = 0, abort_count = 0, execution_time = 0;
+                for(size_t i = 0; i < kMaxThreadNum; i++) {
+                    commit_count += thread_counts_[i].commit_count_.load(std::memory_order_relaxed);
+                    abort_count += thread_counts_[i].abort_count_.load(std::memory_order_relaxed);
+                    execution_time += thread_counts_[i].execution_time_.load(std::memory_order_relaxed);
+                }
+                CCBatchOutcome& outcome = outcomes_[batch_idx];
+                outcome.commit_count_ = commit_count - last_totals_.commit_count_;
+                outcome.abort_count_ = abort_count - last_totals_.abort_count_;
+                outcome.execution_time_ = execution_time - last_totals_.execution_time_;
+                last_totals_.commit_count_ = commit_count;
+                last_totals_.abort_count_ = abort_count;
+                last_totals_.execution_time_ = execution_time;
+                completed_count_.store(batch_idx + 1, std::memory_order_release);
+                lock_.unlock();
+            }
+
+            //number of leading super-batches whose outcome is known
+            size_t GetCompletedCount() const {
+                return completed_count_.load(std::memory_order_acquire);
+            }
+
+            const CCBatchOutcome& GetOutcome(const size_t& batch_idx) const {
+                return outcomes_[batch_idx];
+            }
+
+            void Report() const {
+                static const char* cc_names[kCCTypeNum] = { "LOCK_WAIT", "LOCK_NO_WAIT", "OCC", "SILO" };
+                size_t completed_count = GetCompletedCount();
+                printf("********************** CC POLICY REPORT ************\n");
+                for(size_t i = 0; i < completed_count; i++) {
+                    const CCBatchOutcome& outcome = outcomes_[i];
+                    printf("batch_idx = %d, cc = %s, contention_ratio = %.3f, average_contention = %.1f, commit_count = %llu, abort_count = %llu, execution_time = %llu us\n",
+                        (int)i, cc_names[outcome.cc_type_], outcome.contention_ratio_, outcome.average_contention_,
+                        (unsigned long long)outcome.commit_count_, (unsigned long long)outcome.abort_count_, (unsigned long long)(outcome.execution_time_ / 1000));
+                }
+            }
+
+            static double GetContentionRatio(const PartitionStatistics& stats) {
+                return stats.num_items_ == 0 ? 0.0 : (double)stats.num_contention_items_ / (double)stats.num_items_;
+            }
+
+            static double GetAverageContention(const PartitionStatistics& stats) {
+                return stats.num_contention_items_ == 0 ? 0.0 : (double)stats.total_contention_ / stats.num_contention_items_;
+            }
+
+            static size_t GetContentionLevel(const PartitionStatistics& stats) {
+                if(stats.num_contention_items_ == 0) {
+                    return 0;
+                }
+                return (GetContentionRatio(stats) < 0.2 && GetAverageContention(stats) < 25) ? 1 : 2;
+            }
+
+        private:
+            CCFeedback(const CCFeedback&);
+            CCFeedback& operator=(const CCFeedback&);
+
+        private:
+#ifdef __linux__
+            struct __attribute__((aligned(64))) ThreadCount {
+#else
+            struct ThreadCount {
+#endif
+#if defined(PRECISE_TIMER)
+                PreciseTimeMeasurer timer_;
+#else
+                TimeMeasurer timer_;
+#endif
+                std::atomic<uint64_t> commit_count_;
+                std::atomic<uint64_t> abort_count_;
+                std::atomic<uint64_t> execution_time_;
+            };
+
+            ThreadCount thread_counts_[kMaxThreadNum];
+            std::vector<CCBatchOutcome> outcomes_;
+            CCBatchOutcome last_totals_;
+            std::atomic<size_t> completed_count_;
+            boost::detail::spinlock lock_;
+        };
+
+        extern CCFeedback cc_feedback_;
+
+        /*
+        ** Picks the concurrency control protocol of a super-batch under -DDYNAMIC_CC, from the
+        ** statistics of its partitioning. Called by the scheduler thread only.
+        */
+        class CCPolicy {
+        public:
+            CCPolicy() {}
+            virtual ~CCPolicy() {}
+            virtual ConcurrencyControlType Select(const int& batch_idx, const PartitionStatistics& stats) = 0;
+        private:
+            CCPolicy(const CCPolicy&);
+            CCPolicy& operator=(const CCPolicy&);
+        };
+
+        //OCC unless many items are contended or the contended ones are hot, in which case 2PL
+        class ContentionThresholdCCPolicy : public CCPolicy {
+        public:
+            ContentionThresholdCCPolicy() {}
+            virtual ~ContentionThresholdCCPolicy() {}
+            virtual ConcurrencyControlType Select(const int& batch_idx, const PartitionStatistics& stats) {
+                return CCFeedback::GetContentionLevel(stats) == 2 ? CC_LOCK_WAIT : CC_OCC;
+            }
+        };
+
+        /*
+        ** Class AdaptiveCCPolicy:
+        ** -----------------------
+        ** Learns which protocol commits the most transactions per unit of worker time, separately for
+        ** every contention level, from the outcomes of completed super-batches. Every protocol is
+        ** tried once per level, then the best one is used and every kExplorePeriod-th super-batch of
+        ** a level goes to the protocol tried least recently, so that the policy follows the workload.
+        ** Enabled by -DADAPTIVE_CC_POLICY.
+        */
+        class AdaptiveCCPolicy : public CCPolicy {
+        public:
+            AdaptiveCCPolicy() : next_outcome_idx_(0) {
+                for(size_t i = 0; i < kContentionLevelNum; i++) {
+                    decision_counts_[i] = 0;
+                    for(size_t j = 0; j < kCCTypeNum; j++) {
+                        throughputs_[i][j] = 0.0;
+                        observed_counts_[i][j] = 0;
+                        last_tried_[i][j] = -1;
+                    }
+                }
+            }
+            virtual ~AdaptiveCCPolicy() {}
+            virtual ConcurrencyControlType Select(const int& batch_idx, const PartitionStatistics& stats);
+
+        private:
+            void Observe();
+
+        private:
+            static const size_t kExplorePeriod = 16;
+            //weight of the newest outcome in the throughput estimate
+            static const double kSmoothingFactor;
+
+            size_t next_outcome_idx_;
+            size_t decision_counts_[kContentionLevelNum];
+            //commits per second of worker time
+            double throughputs_[kContentionLevelNum][kCCTypeNum];
+            size_t observed_counts_[kContentionLevelNum][kCCTypeNum];
+            long long last_tried_[kContentionLevelNum][kCCTypeNum];
+        };
+	}
+}
+
+#endif
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_CONCURRENT_UNION_FIND_H__
+#define __CAVALIA_DATABASE_CONCURRENT_UNION_FIND_H__
+
+#include <atomic>
+#include <cstddef>
+#include "../Transaction/TxnParam.h"
+
+namespace Cavalia{
+	namespace Database{
+        //one node per transaction of the super-batch being clustered
+        struct UnionFindNode
+        {
+            std::atomic<UnionFindNode*> parent_;
+            //cluster size, only meaningful at roots. the top bit seals the root while it is being linked
+            std::atomic<size_t> size_;
+            TxnParam* txn_;
+            //position of the cluster in the clustered transaction array, set on roots
+            size_t offset_;
+            std::atomic<size_t> fill_;
+
+            void Reset(TxnParam* txn) {
+                parent_.store(this, std::memory_order_relaxed);
+                size_.store(1, std::memory_order_relaxed);
+                txn_ = txn;
+                offset_ = 0;
+                fill_.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        /*
+        ** Class ConcurrentUnionFind:
+        ** --------------------------
+        ** CAS-based union-find over UnionFindNodes with path halving and union by size. Union refuses
+        ** to build a set of max_size or more nodes, which is how the MAX_ATOMIC_BATCH_SIZE cap is kept
+        ** when several threads merge clusters at the same time.
+        **
+        ** To link root ra under root rb, a thread first seals ra's size word so that nobody can grow ra
+        ** any more, then reserves ra's size in rb's size word and finally links ra. A sealed root is never
+        ** unsealed after it has been linked, so an unsealed size word always belongs to a root.
+        */
+        class ConcurrentUnionFind {
+        public:
+            static UnionFindNode* Find(UnionFindNode* node) {
+                while(true) {
+                    UnionFindNode* parent = node->parent_.load(std::memory_order_acquire);
+                    if(parent == node) {
+                        return node;
+                    }
+                    UnionFindNode* grand_parent = parent->parent_.load(std::memory_order_acquire);
+                    if(grand_parent != parent) {
+                        //path halving. losing the race is fine, grand_parent is still an ancestor
+                        node->parent_.compare_exchange_weak(parent, grand_parent);
+                    }
+                    node = grand_parent;
+                }
+            }
+
+            static size_t GetSize(UnionFindNode* root) {
+                return root->size_.load(std::memory_order_acquire) & ~kSealBit;
+            }
+
+            //returns false iff the two sets are distinct and their union would reach max_size
+            static bool Union(UnionFindNode* n1, UnionFindNode* n2, const size_t& max_size) {
+                while(true) {
+                    UnionFindNode* ra = Find(n1);
+                    UnionFindNode* rb = Find(n2);
+                    if(ra == rb) {
+                        return true;
+                    }
+                    size_t sa = ra->size_.load(std::memory_order_acquire);
+                    size_t sb = rb->size_.load(std::memory_order_acquire);
+                    if((sa & kSealBit) || (sb & kSealBit)) {
+                        //one of them is being linked right now
+                        continue;
+                    }
+                    if(sa + sb >= max_size) {
+                        //sizes only grow, so this union can never succeed
+                        return false;
+                    }
+                    //link the smaller one. ties are broken by address so that racing threads agree
+                    if(sa > sb || (sa == sb && ra > rb)) {
+                        std::swap(ra, rb);
+                        std::swap(sa, sb);
+                    }
+                    if(!ra->size_.compare_exchange_strong(sa, sa | kSealBit)) {
+                        continue;
+                    }
+                    size_t current = sb;
+                    bool reserved = false;
+                    while(true) {
+                        if(current & kSealBit) {
+                            break;
+                        }
+                        if(current + sa >= max_size) {
+                            ra->size_.store(sa, std::memory_order_release);
+                            return false;
+                        }
+                        if(rb->size_.compare_exchange_weak(current, current + sa)) {
+                            reserved = true;
+                            break;
+                        }
+                    }
+                    if(!reserved) {
+                        //rb got sealed by another thread, unseal ra and start over
+                        ra->size_.store(sa, std::memory_order_release);
+                        continue;
+                    }
+                    ra->parent_.store(rb, std::memory_order_release);
+                    return true;
+                }
+            }
+
+        private:
+            static const size_t kSealBit = ((size_t)1) << 63;
+        };
+	}
+}
+
+#endif
@@ -0,0 +1,152 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_DEPENDENCY_GRAPH_H__
+#define __CAVALIA_DATABASE_DEPENDENCY_GRAPH_H__
+
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include "../Transaction/TxnParam.h"
+#include "AccessInfo.h"
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Class DependencyGraph:
+        ** ----------------------
+        ** Used by -DDEPENDENCY_GRAPH_EXECUTION for the transactions of a super-batch whose clusters were
+        ** joined by contended items, i.e. those that could not be fit into one atomic-batch. The
+        ** transactions are put in a deterministic order and every one of them depends on the previous
+        ** transaction that accessed any of its written items, in the spirit of Calvin and BOHM. A
+        ** transaction becomes ready once all its predecessors have been executed, so the whole graph
+        ** runs without concurrency control and without conflicts.
+        **
+        ** The scheduler thread builds the graph before the super-batch is published. Workers take ready
+        ** transactions as one-transaction batches and report them back with Complete().
+        */
+        class DependencyGraph {
+        public:
+            //txns in execution order. all accesses of txns must be free of other transactions.
+            DependencyGraph(const std::vector<TxnParam*>& txns, const ConcurrencyControlType& type) : node_count_(txns.size()), ready_head_(0), ready_tail_(0), completed_count_(0) {
+                nodes_ = new Node[node_count_];
+                ready_ = new std::atomic<size_t>[node_count_];
+                std::unordered_map<BatchAccessInfo*, size_t> last_accessors;
+                for(size_t i = 0; i < node_count_; i++) {
+                    Node& node = nodes_[i];
+                    node.batch_ = new ParamBatch(1);
+                    node.batch_->push_back(txns[i]);
+                #if defined(DYNAMIC_CC)
+                    node.batch_->cc_type_ = type;
+                #endif
+                    ready_[i].store(kNoNode, std::memory_order_relaxed);
+
+                    ReadWriteSet& rw_set = txns[i]->GetReadWriteSet();
+                    for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+                        BatchAccessInfo* info = iter->info_;
+                        //every access of the graph is ordered, nobody else touches these items
+                        info->avoid_cc_ = true;
+                        //reads of a read-only item need no order
+                        if(!info->has_writes_) {
+                            continue;
+                        }
+                        auto last_iter = last_accessors.find(info);
+                        if(last_iter == last_accessors.end()) {
+                            last_accessors[info] = i;
+                        } else {
+                            //the successors of a node are added in increasing order, so duplicates are adjacent
+                            std::vector<size_t>& successors = nodes_[last_iter->second].successors_;
+                            if(successors.empty() || successors.back() != i) {
+                                successors.push_back(i);
+                                node.pending_count_++;
+                            }
+                            last_iter->second = i;
+                        }
+                    }
+                }
+                for(size_t i = 0; i < node_count_; i++) {
+                    nodes_[i].pending_.store(nodes_[i].pending_count_, std::memory_order_relaxed);
+                    if(nodes_[i].pending_count_ == 0) {
+                        PushReady(i);
+                    }
+                }
+            }
+
+            ~DependencyGraph() {
+                for(size_t i = 0; i < node_count_; i++) {
+                    delete nodes_[i].batch_;
+                    nodes_[i].batch_ = NULL;
+                }
+                delete[] nodes_;
+                nodes_ = NULL;
+                delete[] ready_;
+                ready_ = NULL;
+            }
+
+            //returns a ready transaction, or NULL if none is ready right now
+            ParamBatch* GetReady(size_t& node_idx) {
+                size_t head = ready_head_.load(std::memory_order_acquire);
+                while(head < ready_tail_.load(std::memory_order_acquire)) {
+                    size_t ready_node = ready_[head].load(std::memory_order_acquire);
+                    if(ready_node == kNoNode) {
+                        //slot reserved but not filled yet
+                        return NULL;
+                    }
+                    if(ready_head_.compare_exchange_weak(head, head + 1)) {
+                        node_idx = ready_node;
+                        return nodes_[ready_node].batch_;
+                    }
+                }
+                return NULL;
+            }
+
+            //the transaction of node_idx has been executed, release its successors
+            void Complete(const size_t& node_idx) {
+                std::vector<size_t>& successors = nodes_[node_idx].successors_;
+                for(auto iter = successors.begin(); iter != successors.end(); iter++) {
+                    if(nodes_[*iter].pending_.fetch_sub(1) == 1) {
+                        PushReady(*iter);
+                    }
+                }
+                completed_count_.fetch_add(1);
+            }
+
+            bool IsDone() const {
+                return completed_count_.load() == node_count_;
+            }
+
+            size_t GetNodeCount() const {
+                return node_count_;
+            }
+
+        private:
+            DependencyGraph(const DependencyGraph&);
+            DependencyGraph& operator=(const DependencyGraph&);
+
+            //every node is pushed exactly once, so the ready array never wraps
+            void PushReady(const size_t& node_idx) {
+                size_t slot = ready_tail_.fetch_add(1);
+                ready_[slot].store(node_idx, std::memory_order_release);
+            }
+
+        private:
+            struct Node
+            {
+                ParamBatch* batch_;
+                std::vector<size_t> successors_;
+                size_t pending_count_;
+                std::atomic<size_t> pending_;
+                Node() : batch_(NULL), successors_(), pending_count_(0), pending_(0) {}
+            };
+
+            static const size_t kNoNode = (size_t)-1;
+
+            const size_t node_count_;
+            Node* nodes_;
+            std::atomic<size_t>* ready_;
+            std::atomic<size_t> ready_head_;
+            std::atomic<size_t> ready_tail_;
+            std::atomic<size_t> completed_count_;
+        };
+	}
+}
+
+#endif
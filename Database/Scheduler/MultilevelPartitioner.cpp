@@ -0,0 +1,389 @@
+#include "MultilevelPartitioner.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Cavalia;
+using namespace Cavalia::Database;
+
+const size_t MultilevelPartitioner::kInvalidId;
+
+MultilevelPartitioner::MultilevelPartitioner(const size_t& min_part_count, const size_t& max_cluster_size)
+    : min_part_count_(std::max(min_part_count, (size_t)1)),
+      max_cluster_size_(max_cluster_size),
+      part_count_(0),
+      part_capacity_(0),
+      max_vertex_weight_(0),
+      random_(1) {
+    assert(max_cluster_size_ > 1);
+}
+
+void MultilevelPartitioner::Hypergraph::Reset(const size_t& vertex_count) {
+    vertex_weights_.assign(vertex_count, 0);
+    edge_offsets_.assign(1, 0);
+    edge_weights_.clear();
+    pins_.clear();
+}
+
+void MultilevelPartitioner::Hypergraph::BuildIncidence() {
+    size_t vertex_count = GetVertexCount();
+    vertex_offsets_.assign(vertex_count + 1, 0);
+    for(auto iter = pins_.begin(); iter != pins_.end(); iter++) {
+        vertex_offsets_[*iter + 1]++;
+    }
+    for(size_t v = 0; v < vertex_count; v++) {
+        vertex_offsets_[v + 1] += vertex_offsets_[v];
+    }
+    //vertex_offsets_[v] serves as the cursor of v and ends up at the start of v + 1
+    incident_edges_.resize(pins_.size());
+    for(size_t e = 0; e < GetEdgeCount(); e++) {
+        for(size_t i = edge_offsets_[e]; i < edge_offsets_[e + 1]; i++) {
+            incident_edges_[vertex_offsets_[pins_[i]]++] = e;
+        }
+    }
+    for(size_t v = vertex_count; v > 0; v--) {
+        vertex_offsets_[v] = vertex_offsets_[v - 1];
+    }
+    vertex_offsets_[0] = 0;
+}
+
+void MultilevelPartitioner::Cluster(std::vector<TxnParam*>& txns, BumpArena** arenas, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats) {
+    if(levels_.empty()) {
+        levels_.resize(1);
+        coarse_maps_.resize(1);
+        level_parts_.resize(1);
+    }
+    BuildHypergraph(txns, arenas[0], stats);
+    size_t vertex_count = txns.size();
+    if(vertex_count == 0) {
+        return;
+    }
+
+    //parts are at most half full on average, so that the lightest part always has room for a vertex
+    size_t max_part_weight = max_cluster_size_ - 1;
+    part_count_ = std::max(min_part_count_, (2 * vertex_count + max_part_weight - 1) / max_part_weight);
+    part_count_ = std::min(part_count_, vertex_count);
+    part_capacity_ = (size_t)std::ceil(MULTILEVEL_IMBALANCE * vertex_count / part_count_);
+    part_capacity_ = std::min(std::max(part_capacity_, (size_t)1), max_part_weight);
+    max_vertex_weight_ = std::max(part_capacity_ / 4, (size_t)1);
+    vertex_scores_.assign(vertex_count, 0.0);
+    vertex_marks_.resize(vertex_count);
+    part_scores_.assign(part_count_, 0.0);
+    part_pins_.assign(part_count_, 0);
+    part_gains_.assign(part_count_, 0);
+    is_candidate_.assign(part_count_, false);
+
+    /* Phase 1: coarsen */
+    size_t level = 0;
+    while(levels_[level].GetVertexCount() > part_count_ * MULTILEVEL_COARSEST_VERTICES_PER_PART) {
+        if(levels_.size() == level + 1) {
+            levels_.resize(level + 2);
+            coarse_maps_.resize(level + 2);
+            level_parts_.resize(level + 2);
+        }
+        if(!Coarsen(levels_[level], levels_[level + 1], coarse_maps_[level])) {
+            break;
+        }
+        level++;
+    }
+
+    /* Phase 2: partition the coarsest graph */
+    InitialPartition(levels_[level], level_parts_[level]);
+    Refine(levels_[level], level_parts_[level]);
+
+    /* Phase 3: project the parts back onto every finer level and refine them there */
+    while(level > 0) {
+        level--;
+        std::vector<size_t>& coarse_map = coarse_maps_[level];
+        std::vector<size_t>& coarse_parts = level_parts_[level + 1];
+        std::vector<size_t>& parts = level_parts_[level];
+        parts.resize(levels_[level].GetVertexCount());
+        for(size_t v = 0; v < parts.size(); v++) {
+            parts[v] = coarse_parts[coarse_map[v]];
+        }
+        Refine(levels_[level], parts);
+    }
+
+    //an item skips concurrency control iff all its transactions ended up in the same part
+    Hypergraph& graph = levels_[0];
+    std::vector<size_t>& parts = level_parts_[0];
+    for(size_t e = 0; e < graph.GetEdgeCount(); e++) {
+        size_t resulting_cluster_size = 0;
+        for(size_t i = graph.edge_offsets_[e]; i < graph.edge_offsets_[e + 1]; i++) {
+            size_t part = parts[graph.pins_[i]];
+            if(!is_candidate_[part]) {
+                is_candidate_[part] = true;
+                touched_parts_.push_back(part);
+                resulting_cluster_size += part_weights_[part];
+            }
+        }
+        if(touched_parts_.size() == 1) {
+            edge_items_[e]->avoid_cc_ = true;
+        } else {
+            stats.total_contention_ += resulting_cluster_size;
+            stats.num_contention_items_++;
+        }
+        for(auto iter = touched_parts_.begin(); iter != touched_parts_.end(); iter++) {
+            is_candidate_[*iter] = false;
+        }
+        touched_parts_.clear();
+    }
+
+    //lay the parts out contiguously as clusters
+    std::vector<size_t> offsets(part_count_ + 1, 0);
+    for(size_t p = 0; p < part_count_; p++) {
+        offsets[p + 1] = offsets[p] + part_weights_[p];
+    }
+    for(size_t p = 0; p < part_count_; p++) {
+        if(part_weights_[p] != 0) {
+            clusters.push_back(TxnCluster(clustered_txns + offsets[p], part_weights_[p]));
+        }
+    }
+    for(size_t v = 0; v < vertex_count; v++) {
+        clustered_txns[offsets[parts[v]]++] = txns[v];
+        txns[v]->data_ = NULL;
+    }
+}
+
+void MultilevelPartitioner::BuildHypergraph(std::vector<TxnParam*>& txns, BumpArena* arena, PartitionStatistics& stats) {
+    ReadWriteSet batch_rw_set;
+    batch_rw_set.Reset(arena);
+    for(size_t i = 0; i < txns.size(); i++) {
+        TxnParam* txn = txns[i];
+        //data_ points at the slot of txn, which gives its vertex
+        txn->data_ = (char*)&txns[i];
+        BuildReadWriteSet(0, txn, batch_rw_set);
+    }
+    stats.num_txns_ = txns.size();
+    stats.num_items_ = batch_rw_set.size();
+
+    Hypergraph& graph = levels_[0];
+    graph.Reset(txns.size());
+    std::fill(graph.vertex_weights_.begin(), graph.vertex_weights_.end(), 1);
+    edge_items_.clear();
+    for(auto iter = batch_rw_set.begin(); iter != batch_rw_set.end(); iter++) {
+        BatchAccessInfo* info = iter->info_;
+        size_t size = info->txns_.size();
+        if(size == 1) {
+            info->avoid_cc_ = true;
+        } else if(size >= max_cluster_size_) {
+            //no part can hold all its transactions
+            stats.num_contention_items_++;
+            stats.total_contention_ += size;
+        } else {
+            for(auto txn_iter = info->txns_.begin(); txn_iter != info->txns_.end(); txn_iter++) {
+                graph.pins_.push_back((TxnParam**)(*txn_iter)->data_ - txns.data());
+            }
+            graph.edge_offsets_.push_back(graph.pins_.size());
+            //every access to a cut item needs concurrency control
+            graph.edge_weights_.push_back(size);
+            edge_items_.push_back(info);
+        }
+    }
+    graph.BuildIncidence();
+}
+
+bool MultilevelPartitioner::Coarsen(const Hypergraph& fine, Hypergraph& coarse, std::vector<size_t>& coarse_map) {
+    size_t vertex_count = fine.GetVertexCount();
+    coarse_map.assign(vertex_count, kInvalidId);
+    Shuffle(order_, vertex_count);
+
+    //heavy-edge matching: pair every vertex with the unmatched neighbour it shares the most edges with,
+    //where sharing a large edge counts for less
+    size_t coarse_count = 0;
+    for(auto iter = order_.begin(); iter != order_.end(); iter++) {
+        size_t v = *iter;
+        if(coarse_map[v] != kInvalidId) {
+            continue;
+        }
+        for(size_t i = fine.vertex_offsets_[v]; i < fine.vertex_offsets_[v + 1]; i++) {
+            size_t e = fine.incident_edges_[i];
+            double score = (double)fine.edge_weights_[e] / (fine.GetEdgeSize(e) - 1);
+            for(size_t j = fine.edge_offsets_[e]; j < fine.edge_offsets_[e + 1]; j++) {
+                size_t u = fine.pins_[j];
+                if(u != v && coarse_map[u] == kInvalidId && fine.vertex_weights_[u] + fine.vertex_weights_[v] <= max_vertex_weight_) {
+                    if(vertex_scores_[u] == 0.0) {
+                        touched_vertices_.push_back(u);
+                    }
+                    vertex_scores_[u] += score;
+                }
+            }
+        }
+        size_t best = kInvalidId;
+        double best_score = 0.0;
+        for(auto t_iter = touched_vertices_.begin(); t_iter != touched_vertices_.end(); t_iter++) {
+            if(vertex_scores_[*t_iter] > best_score) {
+                best_score = vertex_scores_[*t_iter];
+                best = *t_iter;
+            }
+            vertex_scores_[*t_iter] = 0.0;
+        }
+        touched_vertices_.clear();
+        coarse_map[v] = coarse_count;
+        if(best != kInvalidId) {
+            coarse_map[best] = coarse_count;
+        }
+        coarse_count++;
+    }
+    if(coarse_count * 10 > vertex_count * 9) {
+        return false;
+    }
+
+    coarse.Reset(coarse_count);
+    for(size_t v = 0; v < vertex_count; v++) {
+        coarse.vertex_weights_[coarse_map[v]] += fine.vertex_weights_[v];
+    }
+    std::fill(vertex_marks_.begin(), vertex_marks_.begin() + coarse_count, kInvalidId);
+    for(size_t e = 0; e < fine.GetEdgeCount(); e++) {
+        size_t begin = coarse.pins_.size();
+        for(size_t i = fine.edge_offsets_[e]; i < fine.edge_offsets_[e + 1]; i++) {
+            size_t c = coarse_map[fine.pins_[i]];
+            if(vertex_marks_[c] != e) {
+                vertex_marks_[c] = e;
+                coarse.pins_.push_back(c);
+            }
+        }
+        if(coarse.pins_.size() - begin < 2) {
+            //the edge lies within one vertex, it can no longer be cut
+            coarse.pins_.resize(begin);
+        } else {
+            coarse.edge_offsets_.push_back(coarse.pins_.size());
+            coarse.edge_weights_.push_back(fine.edge_weights_[e]);
+        }
+    }
+    coarse.BuildIncidence();
+    return true;
+}
+
+void MultilevelPartitioner::InitialPartition(const Hypergraph& graph, std::vector<size_t>& parts) {
+    size_t vertex_count = graph.GetVertexCount();
+    parts.assign(vertex_count, kInvalidId);
+    part_weights_.assign(part_count_, 0);
+    Shuffle(order_, vertex_count);
+    std::stable_sort(order_.begin(), order_.end(), [&](const size_t& v1, const size_t& v2) {
+        return graph.vertex_weights_[v1] > graph.vertex_weights_[v2];
+    });
+
+    for(auto iter = order_.begin(); iter != order_.end(); iter++) {
+        size_t v = *iter;
+        size_t weight = graph.vertex_weights_[v];
+        for(size_t i = graph.vertex_offsets_[v]; i < graph.vertex_offsets_[v + 1]; i++) {
+            size_t e = graph.incident_edges_[i];
+            double score = (double)graph.edge_weights_[e] / (graph.GetEdgeSize(e) - 1);
+            for(size_t j = graph.edge_offsets_[e]; j < graph.edge_offsets_[e + 1]; j++) {
+                size_t part = parts[graph.pins_[j]];
+                if(part != kInvalidId) {
+                    if(part_scores_[part] == 0.0) {
+                        touched_parts_.push_back(part);
+                    }
+                    part_scores_[part] += score;
+                }
+            }
+        }
+        size_t best = kInvalidId;
+        double best_score = 0.0;
+        for(auto p_iter = touched_parts_.begin(); p_iter != touched_parts_.end(); p_iter++) {
+            size_t part = *p_iter;
+            if(part_weights_[part] + weight <= part_capacity_ && part_scores_[part] > best_score) {
+                best_score = part_scores_[part];
+                best = part;
+            }
+            part_scores_[part] = 0.0;
+        }
+        touched_parts_.clear();
+        if(best == kInvalidId) {
+            best = std::min_element(part_weights_.begin(), part_weights_.end()) - part_weights_.begin();
+        }
+        parts[v] = best;
+        part_weights_[best] += weight;
+    }
+}
+
+void MultilevelPartitioner::Refine(const Hypergraph& graph, std::vector<size_t>& parts) {
+    size_t vertex_count = graph.GetVertexCount();
+    for(size_t pass = 0; pass < MULTILEVEL_REFINEMENT_PASSES; pass++) {
+        size_t move_count = 0;
+        Shuffle(order_, vertex_count);
+        for(auto iter = order_.begin(); iter != order_.end(); iter++) {
+            size_t v = *iter;
+            size_t from = parts[v];
+            size_t weight = graph.vertex_weights_[v];
+            ComputeMoveGains(graph, parts, v);
+            //take the best gain, or a move that evens out the parts without cutting anything
+            size_t best = kInvalidId;
+            long long best_gain = 0;
+            for(auto p_iter = candidate_parts_.begin(); p_iter != candidate_parts_.end(); p_iter++) {
+                size_t to = *p_iter;
+                long long gain = part_gains_[to];
+                if(part_weights_[to] + weight > part_capacity_) {
+                    continue;
+                }
+                if(gain > best_gain || (gain == 0 && best_gain == 0 && best == kInvalidId && part_weights_[to] + weight < part_weights_[from])) {
+                    best_gain = gain;
+                    best = to;
+                }
+            }
+            for(auto p_iter = candidate_parts_.begin(); p_iter != candidate_parts_.end(); p_iter++) {
+                part_gains_[*p_iter] = 0;
+                is_candidate_[*p_iter] = false;
+            }
+            candidate_parts_.clear();
+            if(best != kInvalidId) {
+                parts[v] = best;
+                part_weights_[from] -= weight;
+                part_weights_[best] += weight;
+                move_count++;
+            }
+        }
+        if(move_count == 0) {
+            break;
+        }
+    }
+}
+
+void MultilevelPartitioner::ComputeMoveGains(const Hypergraph& graph, const std::vector<size_t>& parts, const size_t& vertex) {
+    size_t from = parts[vertex];
+    long long loss = 0;
+    for(size_t i = graph.vertex_offsets_[vertex]; i < graph.vertex_offsets_[vertex + 1]; i++) {
+        size_t e = graph.incident_edges_[i];
+        size_t size = graph.GetEdgeSize(e);
+        for(size_t j = graph.edge_offsets_[e]; j < graph.edge_offsets_[e + 1]; j++) {
+            size_t part = parts[graph.pins_[j]];
+            if(part_pins_[part] == 0) {
+                touched_parts_.push_back(part);
+            }
+            part_pins_[part]++;
+        }
+        if(part_pins_[from] == size) {
+            //uncut now, cut wherever vertex goes
+            loss += graph.edge_weights_[e];
+        }
+        for(auto iter = touched_parts_.begin(); iter != touched_parts_.end(); iter++) {
+            size_t part = *iter;
+            if(part != from) {
+                if(!is_candidate_[part]) {
+                    is_candidate_[part] = true;
+                    candidate_parts_.push_back(part);
+                }
+                if(part_pins_[part] == size - 1) {
+                    //vertex is the only pin outside of part
+                    part_gains_[part] += graph.edge_weights_[e];
+                }
+            }
+            part_pins_[part] = 0;
+        }
+        touched_parts_.clear();
+    }
+    for(auto iter = candidate_parts_.begin(); iter != candidate_parts_.end(); iter++) {
+        part_gains_[*iter] -= loss;
+    }
+}
+
+void MultilevelPartitioner::Shuffle(std::vector<size_t>& order, const size_t& size) {
+    order.resize(size);
+    for(size_t i = 0; i < size; i++) {
+        order[i] = i;
+    }
+    for(size_t i = size; i > 1; i--) {
+        std::swap(order[i - 1], order[random_.next() % i]);
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_MULTILEVEL_PARTITIONER_H__
+#define __CAVALIA_DATABASE_MULTILEVEL_PARTITIONER_H__
+
+#include <vector>
+#include <FastRandom.h>
+#include "BasePartitioner.h"
+
+//parts may exceed the average weight by this factor
+#define MULTILEVEL_IMBALANCE 1.1
+//coarsening stops once the graph has at most this many vertices per part
+#define MULTILEVEL_COARSEST_VERTICES_PER_PART 8
+#define MULTILEVEL_REFINEMENT_PASSES 4
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Class MultilevelPartitioner:
+        ** ----------------------------
+        ** Min-cut alternative to the greedy merge by item degree, selected with -g1 (gPartitionerType).
+        ** The super-batch is a hypergraph whose vertices are the transactions and whose hyperedges are the
+        ** items accessed by more than one of them, weighted by that degree. Following METIS, the graph is
+        ** cut into k balanced parts in three phases:
+        **
+        ** 1. coarsening: transactions are matched with the unmatched neighbour they share the most items
+        **    with, and every pair is contracted into one vertex, until the graph is small enough.
+        ** 2. initial partitioning: the vertices of the coarsest graph are assigned, heaviest first, to the
+        **    part they are most connected to that still has room, or else to the lightest part.
+        ** 3. uncoarsening: the parts are projected back level by level, and vertices are moved to the
+        **    neighbouring part that uncuts the most item weight while the parts stay balanced.
+        **
+        ** The cut weight is the number of accesses that need concurrency control: an item skips it iff all
+        ** its transactions end up in the same part. Every part becomes one cluster, so k is chosen such that
+        ** parts stay below max_cluster_size and there are at least min_part_count of them.
+        */
+        class MultilevelPartitioner : public BasePartitioner {
+        public:
+            MultilevelPartitioner(const size_t& min_part_count, const size_t& max_cluster_size);
+            virtual ~MultilevelPartitioner() {}
+
+            virtual void Cluster(std::vector<TxnParam*>& txns, BumpArena** arenas, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats);
+
+        private:
+            MultilevelPartitioner(const MultilevelPartitioner&);
+            MultilevelPartitioner& operator=(const MultilevelPartitioner&);
+
+            struct Hypergraph
+            {
+                std::vector<size_t> vertex_weights_;
+                //pins of edge e are pins_[edge_offsets_[e]] to pins_[edge_offsets_[e + 1] - 1]
+                std::vector<size_t> edge_offsets_;
+                std::vector<size_t> edge_weights_;
+                std::vector<size_t> pins_;
+                //edges of vertex v are incident_edges_[vertex_offsets_[v]] to incident_edges_[vertex_offsets_[v + 1] - 1]
+                std::vector<size_t> vertex_offsets_;
+                std::vector<size_t> incident_edges_;
+
+                size_t GetVertexCount() const { return vertex_weights_.size(); }
+                size_t GetEdgeCount() const { return edge_weights_.size(); }
+                size_t GetEdgeSize(const size_t& edge) const { return edge_offsets_[edge + 1] - edge_offsets_[edge]; }
+
+                void Reset(const size_t& vertex_count);
+                //derives the incident edges of every vertex from the pins
+                void BuildIncidence();
+            };
+
+            //builds the first level from the read-write sets of txns, settling the items no edge stands for
+            void BuildHypergraph(std::vector<TxnParam*>& txns, BumpArena* arena, PartitionStatistics& stats);
+            //returns false if matching barely shrinks fine, in which case coarse is garbage
+            bool Coarsen(const Hypergraph& fine, Hypergraph& coarse, std::vector<size_t>& coarse_map);
+            void InitialPartition(const Hypergraph& graph, std::vector<size_t>& parts);
+            void Refine(const Hypergraph& graph, std::vector<size_t>& parts);
+            //weight of the edges of vertex that moving it to each neighbouring part uncuts, minus the weight
+            //of those it cuts. Leaves the candidate parts in candidate_parts_ and their gains in part_gains_.
+            void ComputeMoveGains(const Hypergraph& graph, const std::vector<size_t>& parts, const size_t& vertex);
+            void Shuffle(std::vector<size_t>& order, const size_t& size);
+
+        private:
+            static const size_t kInvalidId = (size_t)-1;
+
+            const size_t min_part_count_;
+            const size_t max_cluster_size_;
+            size_t part_count_;
+            size_t part_capacity_;
+            size_t max_vertex_weight_;
+            fast_random random_;
+
+            //level 0 is the graph of the super-batch, every next level is coarser
+            std::vector<Hypergraph> levels_;
+            //maps the vertices of each level onto those of the next one
+            std::vector<std::vector<size_t>> coarse_maps_;
+            //parts of the vertices of each level
+            std::vector<std::vector<size_t>> level_parts_;
+            //item of every edge of level 0
+            std::vector<BatchAccessInfo*> edge_items_;
+            std::vector<size_t> part_weights_;
+
+            //scratch, indexed by vertex
+            std::vector<size_t> order_;
+            std::vector<double> vertex_scores_;
+            std::vector<size_t> touched_vertices_;
+            std::vector<size_t> vertex_marks_;
+            //scratch, indexed by part
+            std::vector<double> part_scores_;
+            std::vector<size_t> part_pins_;
+            std::vector<long long> part_gains_;
+            std::vector<char> is_candidate_;
+            std::vector<size_t> touched_parts_;
+            std::vector<size_t> candidate_parts_;
+        };
+	}
+}
+
+#endif
@@ -0,0 +1,290 @@
+#include "ParallelPartitioner.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace Cavalia;
+using namespace Cavalia::Database;
+
+ParallelPartitioner::ParallelPartitioner(const size_t& thread_count, const size_t& max_cluster_size)
+    : thread_count_(thread_count),
+      max_cluster_size_(max_cluster_size),
+      barrier_(thread_count),
+      job_count_(0),
+      is_stopped_(false),
+      txns_(NULL),
+      arenas_(NULL),
+      clustered_txns_(NULL),
+      clusters_(NULL),
+      nodes_(NULL),
+      nodes_capacity_(0),
+      sorted_items_() {
+    assert(thread_count_ > 0);
+    //new does not honor the cache-line alignment of ThreadState before c++17
+    void* states_ptr = NULL;
+    int ret = posix_memalign(&states_ptr, 64, sizeof(ThreadState) * thread_count_);
+    assert(ret == 0);
+    states_ = (ThreadState*)states_ptr;
+    for(size_t i = 0; i < thread_count_; i++) {
+        new(&states_[i]) ThreadState();
+        states_[i].outgoing_.resize(thread_count_);
+    }
+}
+
+ParallelPartitioner::~ParallelPartitioner() {
+    for(size_t i = 0; i < thread_count_; i++) {
+        states_[i].~ThreadState();
+    }
+    free(states_);
+    states_ = NULL;
+    delete[] nodes_;
+    nodes_ = NULL;
+}
+
+void ParallelPartitioner::Start() {
+    for(size_t i = 1; i < thread_count_; i++) {
+        helpers_.create_thread(boost::bind(&ParallelPartitioner::HelperRun, this, i));
+    }
+}
+
+void ParallelPartitioner::Stop() {
+    is_stopped_ = true;
+    job_count_.fetch_add(1);
+    helpers_.join_all();
+}
+
+void ParallelPartitioner::HelperRun(const size_t& thread_id) {
+    size_t seen_job_count = 0;
+    while(true) {
+        while(job_count_.load() == seen_job_count);
+        seen_job_count++;
+        if(is_stopped_) {
+            return;
+        }
+        RunPhases(thread_id);
+    }
+}
+
+void ParallelPartitioner::Cluster(std::vector<TxnParam*>& txns, BumpArena** arenas, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats) {
+    if(nodes_capacity_ < txns.size()) {
+        delete[] nodes_;
+        nodes_ = new UnionFindNode[txns.size()];
+        nodes_capacity_ = txns.size();
+    }
+    txns_ = &txns;
+    arenas_ = arenas;
+    clustered_txns_ = clustered_txns;
+    clusters_ = &clusters;
+
+    //wake up the helpers and take part as thread 0
+    job_count_.fetch_add(1);
+    RunPhases(0);
+
+    stats.num_txns_ = txns.size();
+    for(size_t i = 0; i < thread_count_; i++) {
+        stats.num_items_ += states_[i].num_items_;
+        stats.num_contention_items_ += states_[i].num_contention_items_;
+        stats.total_contention_ += states_[i].total_contention_;
+    }
+}
+
+void ParallelPartitioner::RunPhases(const size_t& thread_id) {
+    BuildLocalReadWriteSets(thread_id);
+    barrier_.Wait();
+    MergeShard(thread_id);
+    barrier_.Wait();
+    RelinkReadWriteSets(thread_id);
+    if(thread_id == 0) {
+        SortInterestingItems();
+    }
+    barrier_.Wait();
+    UnionItems(thread_id);
+    barrier_.Wait();
+    ValidateItems(thread_id);
+    CollectRoots(thread_id);
+    barrier_.Wait();
+    if(thread_id == 0) {
+        LayoutClusters();
+    }
+    barrier_.Wait();
+    PlaceMembers(thread_id);
+    barrier_.Wait();
+}
+
+void ParallelPartitioner::BuildLocalReadWriteSets(const size_t& thread_id) {
+    ThreadState& state = states_[thread_id];
+    state.local_set_.Reset(arenas_[thread_id]);
+    for(size_t i = 0; i < thread_count_; i++) {
+        state.outgoing_[i].clear();
+    }
+    state.interesting_items_.clear();
+    state.roots_.clear();
+    state.num_items_ = 0;
+    state.num_contention_items_ = 0;
+    state.total_contention_ = 0;
+
+    size_t begin = txns_->size() * thread_id / thread_count_;
+    size_t end = txns_->size() * (thread_id + 1) / thread_count_;
+    for(size_t i = begin; i < end; i++) {
+        TxnParam* txn = (*txns_)[i];
+        nodes_[i].Reset(txn);
+        txn->data_ = (char*)&nodes_[i];
+        BuildReadWriteSet(thread_id, txn, state.local_set_);
+    }
+    for(auto iter = state.local_set_.begin(); iter != state.local_set_.end(); iter++) {
+        state.outgoing_[GetShard(iter->hash_)].push_back(iter->info_);
+    }
+}
+
+void ParallelPartitioner::MergeShard(const size_t& thread_id) {
+    ThreadState& state = states_[thread_id];
+    ReadWriteSet& shard_set = state.shard_set_;
+    shard_set.Reset(arenas_[thread_id]);
+    for(size_t i = 0; i < thread_count_; i++) {
+        std::vector<BatchAccessInfo*>& incoming = states_[i].outgoing_[thread_id];
+        for(auto iter = incoming.begin(); iter != incoming.end(); iter++) {
+            BatchAccessInfo* partial = *iter;
+            //always merge into a fresh item, the arena of the partial one belongs to another thread
+            BatchAccessInfo* merged = shard_set.GetOrAdd(partial->hash_);
+            merged->txns_.insert(partial->txns_.begin(), partial->txns_.end());
+            merged->has_writes_ = merged->has_writes_ || partial->has_writes_;
+        }
+    }
+
+    for(auto iter = shard_set.begin(); iter != shard_set.end(); iter++) {
+        BatchAccessInfo* info = iter->info_;
+        size_t size = info->txns_.size();
+        state.num_items_++;
+        if(size == 1) {
+            info->avoid_cc_ = true;
+        } else if(size < max_cluster_size_) {
+            state.interesting_items_.push_back(info);
+        } else {
+            state.num_contention_items_++;
+            state.total_contention_ += size;
+        }
+    }
+}
+
+void ParallelPartitioner::RelinkReadWriteSets(const size_t& thread_id) {
+    size_t begin = txns_->size() * thread_id / thread_count_;
+    size_t end = txns_->size() * (thread_id + 1) / thread_count_;
+    for(size_t i = begin; i < end; i++) {
+        ReadWriteSet& rw_set = (*txns_)[i]->GetReadWriteSet();
+        for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+            iter->info_ = states_[GetShard(iter->hash_)].shard_set_.Get(iter->hash_);
+        }
+    }
+}
+
+void ParallelPartitioner::SortInterestingItems() {
+    //counting sort, degrees are bounded by max_cluster_size_
+    std::vector<size_t> offsets(max_cluster_size_ + 1, 0);
+    size_t total = 0;
+    for(size_t i = 0; i < thread_count_; i++) {
+        std::vector<BatchAccessInfo*>& items = states_[i].interesting_items_;
+        for(auto iter = items.begin(); iter != items.end(); iter++) {
+            offsets[(*iter)->txns_.size()]++;
+        }
+        total += items.size();
+    }
+    size_t offset = 0;
+    for(size_t degree = 0; degree <= max_cluster_size_; degree++) {
+        size_t count = offsets[degree];
+        offsets[degree] = offset;
+        offset += count;
+    }
+    sorted_items_.resize(total);
+    for(size_t i = 0; i < thread_count_; i++) {
+        std::vector<BatchAccessInfo*>& items = states_[i].interesting_items_;
+        for(auto iter = items.begin(); iter != items.end(); iter++) {
+            sorted_items_[offsets[(*iter)->txns_.size()]++] = *iter;
+        }
+    }
+}
+
+size_t ParallelPartitioner::GetResultingClusterSize(BatchAccessInfo* info, std::vector<UnionFindNode*>& roots) {
+    size_t resulting_cluster_size = 0;
+    roots.clear();
+    for(auto iter = info->txns_.begin(); iter != info->txns_.end(); iter++) {
+        UnionFindNode* root = ConcurrentUnionFind::Find(GetNode(*iter));
+        if(std::find(roots.begin(), roots.end(), root) == roots.end()) {
+            roots.push_back(root);
+            resulting_cluster_size += ConcurrentUnionFind::GetSize(root);
+        }
+    }
+    return resulting_cluster_size;
+}
+
+void ParallelPartitioner::UnionItems(const size_t& thread_id) {
+    ThreadState& state = states_[thread_id];
+    //threads interleave over the sorted items so that low degree items are merged first
+    for(size_t i = thread_id; i < sorted_items_.size(); i += thread_count_) {
+        BatchAccessInfo* info = sorted_items_[i];
+        if(GetResultingClusterSize(info, state.scratch_roots_) >= max_cluster_size_) {
+            continue;
+        }
+        auto iter = info->txns_.begin();
+        UnionFindNode* first = GetNode(*iter);
+        for(iter++; iter != info->txns_.end(); iter++) {
+            if(!ConcurrentUnionFind::Union(first, GetNode(*iter), max_cluster_size_)) {
+                break;
+            }
+        }
+    }
+}
+
+void ParallelPartitioner::ValidateItems(const size_t& thread_id) {
+    ThreadState& state = states_[thread_id];
+    for(size_t i = thread_id; i < sorted_items_.size(); i += thread_count_) {
+        BatchAccessInfo* info = sorted_items_[i];
+        size_t resulting_cluster_size = GetResultingClusterSize(info, state.scratch_roots_);
+        if(state.scratch_roots_.size() == 1) {
+            info->avoid_cc_ = true;
+        } else {
+            state.num_contention_items_++;
+            state.total_contention_ += resulting_cluster_size;
+        }
+    }
+}
+
+void ParallelPartitioner::CollectRoots(const size_t& thread_id) {
+    ThreadState& state = states_[thread_id];
+    size_t begin = txns_->size() * thread_id / thread_count_;
+    size_t end = txns_->size() * (thread_id + 1) / thread_count_;
+    for(size_t i = begin; i < end; i++) {
+        UnionFindNode* node = &nodes_[i];
+        UnionFindNode* root = ConcurrentUnionFind::Find(node);
+        if(root == node) {
+            state.roots_.push_back(node);
+        } else {
+            node->parent_.store(root, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ParallelPartitioner::LayoutClusters() {
+    size_t offset = 0;
+    for(size_t i = 0; i < thread_count_; i++) {
+        std::vector<UnionFindNode*>& roots = states_[i].roots_;
+        for(auto iter = roots.begin(); iter != roots.end(); iter++) {
+            UnionFindNode* root = *iter;
+            size_t size = ConcurrentUnionFind::GetSize(root);
+            root->offset_ = offset;
+            clusters_->push_back(TxnCluster(clustered_txns_ + offset, size));
+            offset += size;
+        }
+    }
+    assert(offset == txns_->size());
+}
+
+void ParallelPartitioner::PlaceMembers(const size_t& thread_id) {
+    size_t begin = txns_->size() * thread_id / thread_count_;
+    size_t end = txns_->size() * (thread_id + 1) / thread_count_;
+    for(size_t i = begin; i < end; i++) {
+        UnionFindNode* node = &nodes_[i];
+        //parents were flattened by CollectRoots
+        UnionFindNode* root = node->parent_.load(std::memory_order_relaxed);
+        clustered_txns_[root->offset_ + root->fill_.fetch_add(1)] = node->txn_;
+        node->txn_->data_ = NULL;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_PARALLEL_PARTITIONER_H__
+#define __CAVALIA_DATABASE_PARALLEL_PARTITIONER_H__
+
+#include <vector>
+#include <atomic>
+#include <boost/thread.hpp>
+#include <SpinBarrier.h>
+#include "../Transaction/TxnParam.h"
+#include "AccessInfo.h"
+#include "ConcurrentUnionFind.h"
+#include "BasePartitioner.h"
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Class ParallelPartitioner:
+        ** --------------------------
+        ** Parallel version of steps 1-3 of SharedWorklistScheduler::DoDataBasedPartition, enabled by
+        ** -DPARALLEL_PARTITIONING. The calling thread and thread_count - 1 helper threads cluster a
+        ** super-batch in phases separated by barriers:
+        **
+        ** 1. each thread builds the read-write sets of its slice of transactions into a private table
+        **    and buckets the resulting items by key shard.
+        ** 2. each thread owns one key shard and merges the partial items of all threads into a single
+        **    BatchAccessInfo per key.
+        ** 3. each thread points the read-write sets of its transactions at the merged items, while the
+        **    calling thread orders the interesting items by degree.
+        ** 4. items are unioned in increasing order of degree through a ConcurrentUnionFind, so merging two
+        **    clusters costs O(1) instead of rewriting the txns_ set of every item they touch.
+        ** 5. an item may skip concurrency control iff all its transactions ended up in the same cluster.
+        ** 6. clusters are laid out contiguously and returned as TxnClusters.
+        */
+        class ParallelPartitioner : public BasePartitioner {
+        public:
+            ParallelPartitioner(const size_t& thread_count, const size_t& max_cluster_size);
+            virtual ~ParallelPartitioner();
+
+            virtual void Start();
+            virtual void Stop();
+            virtual void Cluster(std::vector<TxnParam*>& txns, BumpArena** arenas, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats);
+
+        private:
+            ParallelPartitioner(const ParallelPartitioner&);
+            ParallelPartitioner& operator=(const ParallelPartitioner&);
+
+            void HelperRun(const size_t& thread_id);
+            void RunPhases(const size_t& thread_id);
+
+            void BuildLocalReadWriteSets(const size_t& thread_id);
+            void MergeShard(const size_t& thread_id);
+            void RelinkReadWriteSets(const size_t& thread_id);
+            void SortInterestingItems();
+            void UnionItems(const size_t& thread_id);
+            void ValidateItems(const size_t& thread_id);
+            void CollectRoots(const size_t& thread_id);
+            void LayoutClusters();
+            void PlaceMembers(const size_t& thread_id);
+
+            size_t GetShard(const int64_t& hash) const {
+                return (size_t)(((uint64_t)hash * 0x9E3779B97F4A7C15ULL) >> 32) % thread_count_;
+            }
+
+            //sum of the sizes of the distinct clusters currently holding the transactions of info
+            size_t GetResultingClusterSize(BatchAccessInfo* info, std::vector<UnionFindNode*>& roots);
+
+            UnionFindNode* GetNode(TxnParam* txn) const {
+                return (UnionFindNode*)txn->data_;
+            }
+
+        private:
+#ifdef __linux__
+            struct __attribute__((aligned(64))) ThreadState {
+#else
+            struct ThreadState {
+#endif
+                ReadWriteSet local_set_;
+                //partial items of this thread, bucketed by the shard that owns their key
+                std::vector<std::vector<BatchAccessInfo*>> outgoing_;
+                ReadWriteSet shard_set_;
+                std::vector<BatchAccessInfo*> interesting_items_;
+                std::vector<UnionFindNode*> roots_;
+                std::vector<UnionFindNode*> scratch_roots_;
+                size_t num_items_;
+                size_t num_contention_items_;
+                size_t total_contention_;
+            };
+
+            const size_t thread_count_;
+            const size_t max_cluster_size_;
+            ThreadState* states_;
+            SpinBarrier barrier_;
+            boost::thread_group helpers_;
+            std::atomic<size_t> job_count_;
+            volatile bool is_stopped_;
+
+            //current job
+            std::vector<TxnParam*>* txns_;
+            BumpArena** arenas_;
+            TxnParam** clustered_txns_;
+            std::vector<TxnCluster>* clusters_;
+            UnionFindNode* nodes_;
+            size_t nodes_capacity_;
+            std::vector<BatchAccessInfo*> sorted_items_;
+        };
+	}
+}
+
+#endif
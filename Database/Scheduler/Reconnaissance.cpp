@@ -0,0 +1,39 @@
+#if defined(RECONNAISSANCE)
+#include "Reconnaissance.h"
+#include "../Executor/ConcurrentExecutor.h"
+
+using namespace Cavalia;
+using namespace Cavalia::Database;
+
+Reconnaissance::Reconnaissance(ConcurrentExecutor* executor) : executor_(executor) {
+    txn_manager_ = new ReconnaissanceManager(executor->GetStorageManager());
+    procedures_ = executor->CreateProcedures(txn_manager_, 0);
+    ret_.char_ptr_ = new char[1024];
+    ret_.size_ = 0;
+}
+
+Reconnaissance::~Reconnaissance() {
+    executor_->DestroyProcedures(procedures_);
+    procedures_ = NULL;
+    delete txn_manager_;
+    txn_manager_ = NULL;
+    delete[] ret_.char_ptr_;
+    ret_.char_ptr_ = NULL;
+}
+
+void Reconnaissance::BuildReadWriteSet(TxnParam* txn, ReadWriteSet& batch_rw_set) {
+    BumpArena* arena = batch_rw_set.GetArena();
+    //the set of the previous super-batch went away with its arena
+    txn->recon_rw_set_ = new (arena->Alloc(sizeof(ReadWriteSet))) ReadWriteSet();
+    txn->recon_rw_set_->Reset(arena);
+    txn->is_reconnoitered_ = !txn->BuildReadWriteSet(batch_rw_set);
+    if(!txn->is_reconnoitered_) {
+        return;
+    }
+    txn_manager_->BeginReconnaissance(txn, &batch_rw_set);
+    ret_.size_ = 0;
+    //the run only fails where the procedure gives up on what it read, the set then holds what it got to
+    procedures_[txn->type_]->Execute(txn, ret_, exe_context_);
+    txn_manager_->EndReconnaissance();
+}
+#endif
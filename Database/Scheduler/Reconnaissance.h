@@ -0,0 +1,50 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_RECONNAISSANCE_H__
+#define __CAVALIA_DATABASE_RECONNAISSANCE_H__
+
+#if defined(RECONNAISSANCE)
+#include "../Transaction/TxnParam.h"
+#include "../Transaction/StoredProcedure.h"
+#include "../Transaction/ReconnaissanceManager.h"
+#include "AccessInfo.h"
+
+namespace Cavalia{
+	namespace Database{
+        class ConcurrentExecutor;
+
+        /*
+        ** Class Reconnaissance:
+        ** ---------------------
+        ** Builds the read-write set of a transaction for the partitioner, enabled by -DRECONNAISSANCE.
+        ** Transactions whose parameters cannot tell every item they access are executed once through a
+        ** ReconnaissanceManager, on the state left by the super-batches partitioned so far, and get the
+        ** items of that run as their read-write set. Every partitioning thread owns one.
+        **
+        ** The set may be stale by the time the transaction executes. The executor aborts a reconnoitered
+        ** transaction as soon as it selects an item outside of its set and defers it: deferred transactions
+        ** are executed alone, with full concurrency control, at the barrier closing the super-batch.
+        */
+        class Reconnaissance {
+        public:
+            Reconnaissance(ConcurrentExecutor* executor);
+            ~Reconnaissance();
+
+            //declares the items of txn in batch_rw_set, running the procedure if its parameters fall short
+            void BuildReadWriteSet(TxnParam* txn, ReadWriteSet& batch_rw_set);
+
+        private:
+            Reconnaissance(const Reconnaissance&);
+            Reconnaissance& operator=(const Reconnaissance&);
+
+        private:
+            ConcurrentExecutor* executor_;
+            ReconnaissanceManager* txn_manager_;
+            StoredProcedure** procedures_;
+            CharArray ret_;
+            ExeContext exe_context_;
+        };
+	}
+}
+#endif
+
+#endif
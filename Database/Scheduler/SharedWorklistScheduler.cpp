@@ -1,10 +1,25 @@
 #include "SharedWorklistScheduler.h"
+#include <algorithm>
 #include "../Executor/ConcurrentExecutor.h"
 
 using namespace Cavalia;
 using namespace Cavalia::Database;
 
 
+SharedWorklistScheduler::~SharedWorklistScheduler() {
+    //the executor never hands the scheduler back, but free what we own anyway
+    for(auto iter = arenas_.begin(); iter != arenas_.end(); iter++) {
+        delete *iter;
+    }
+    arenas_.clear();
+    delete deferred_batch_;
+    deferred_batch_ = NULL;
+    #if defined(DYNAMIC_CC)
+        delete cc_policy_;
+        cc_policy_ = NULL;
+    #endif
+}
+
 void SharedWorklistScheduler::Initialize(const size_t& thread_id) {
     std::vector<ParamBatch*>* execution_batches = new std::vector<ParamBatch*>();
     std::vector<ParamBatch*>* input_batches = redirector_ptr_->GetParameterBatches(thread_id);
@@ -31,34 +46,161 @@ void SharedWorklistScheduler::Initialize(const size_t& thread_id) {
 }
 
 
-void SharedWorklistScheduler::SynchronizeBatchExecution(const size_t& thread_id) {
+void SharedWorklistScheduler::DeferTransaction(const size_t& thread_id, TxnParam* txn) {
+    deferred_txns_[thread_id].push_back(txn);
+}
+
+ParamBatch* SharedWorklistScheduler::SynchronizeBatchExecution(const size_t& thread_id) {
     BEGIN_BATCH_SYNC_TIME_MEASURE(thread_id);
     int next_batch_idx = current_batch_idx_.load() + 1;
     lock_.lock();
     waiting_threads_.push_back(thread_id);
     if(waiting_threads_.size() == thread_count_) {
+        //every other worker is waiting, so the previous deferred batch is done and the
+        //deferred transactions can be executed without anyone to conflict with
+        delete deferred_batch_;
+        deferred_batch_ = NULL;
+        size_t deferred_count = 0;
+        for(size_t i = 0; i < thread_count_; i++) {
+            deferred_count += deferred_txns_[i].size();
+        }
+        if(deferred_count > 0) {
+            deferred_batch_ = new ParamBatch(deferred_count);
+            for(size_t i = 0; i < thread_count_; i++) {
+                for(auto iter = deferred_txns_[i].begin(); iter != deferred_txns_[i].end(); iter++) {
+                    (*iter)->is_reconnoitered_ = false;
+                    deferred_batch_->push_back(*iter);
+                }
+                deferred_txns_[i].clear();
+            }
+            waiting_threads_.pop_back();
+            lock_.unlock();
+            END_BATCH_SYNC_TIME_MEASURE(thread_id);
+            return deferred_batch_;
+        }
         waiting_threads_.clear();
+        #if defined(DYNAMIC_CC)
+            cc_feedback_.CompleteBatch(next_batch_idx - 1);
+        #endif
+        COMPLETE_BATCH_ANALYTICS(next_batch_idx - 1);
         current_batch_idx_.fetch_add(1);
     }
     lock_.unlock();
     while(current_batch_idx_.load() < next_batch_idx);
     END_BATCH_SYNC_TIME_MEASURE(thread_id);
+    return NULL;
 }
 
 void SharedWorklistScheduler::ThreadRun() {
-    BEGIN_PARTITIONING_TIME_MEASURE(0);
-    size_t num_batches = raw_batches_[0]->size();
-    for(int batch_idx = 0; batch_idx < num_batches; batch_idx++) {
+    num_batches_ = raw_batches_[0]->size();
+    if(gPartitionerType == MULTILEVEL_PARTITIONER) {
+        partitioner_ = new MultilevelPartitioner(thread_count_, MAX_ATOMIC_BATCH_SIZE);
+    } else {
+    #if defined(PARALLEL_PARTITIONING)
+        partitioner_ = new ParallelPartitioner(gPartitionThreadCount, MAX_ATOMIC_BATCH_SIZE);
+    #endif
+    }
+    #if defined(RECONNAISSANCE)
+        for(size_t i = 0; i < GetPartitionThreadCount(); i++) {
+            reconnaissances_.push_back(new Reconnaissance(executor_));
+        }
+        if(partitioner_ != NULL) {
+            partitioner_->SetReconnaissances(reconnaissances_.data());
+        }
+    #endif
+    if(partitioner_ != NULL) {
+        partitioner_->Start();
+    }
+    #if defined(DYNAMIC_CC)
+        #if defined(ADAPTIVE_CC_POLICY)
+            cc_policy_ = new AdaptiveCCPolicy();
+        #else
+            cc_policy_ = new ContentionThresholdCCPolicy();
+        #endif
+        cc_feedback_.Reserve(num_batches_);
+    #endif
+    RESERVE_BATCH_ANALYTICS(num_batches_);
+    #if defined(PIPELINED_PARTITIONING)
+        size_t initial_batch_count = std::min((size_t)INITIAL_PRE_PROCESS_BATCH_COUNT, num_batches_);
+        batches_.Reserve(std::max((size_t)LOOKAHEAD_BATCH_COUNT, initial_batch_count));
+    #else
+        size_t initial_batch_count = num_batches_;
+        batches_.Reserve(std::max(num_batches_, (size_t)1));
+    #endif
+    #if defined(SELECTIVE_CC)
+        for(size_t i = 0; i < batches_.Capacity() * GetPartitionThreadCount(); i++) {
+            arenas_.push_back(new BumpArena());
+        }
+        footprints_.resize(batches_.Capacity());
+    #endif
+
+    for(int batch_idx = 0; batch_idx < num_batches_; batch_idx++) {
+        if(batch_idx == initial_batch_count) {
+            std::cout << "done with scheduler initial run..." << std::endl;
+            START_BATCH_ANALYTICS;
+            executor_->is_scheduler_ready_ = true;
+        }
+
+        //do not run more than capacity super-batches ahead of the workers
+        while(batch_idx - GetCompletedBatchCount() >= (int)batches_.Capacity());
+
+        bool is_hidden = executor_->is_scheduler_ready_;
+        BEGIN_PARTITIONING_TIME_MEASURE(0);
+        BEGIN_BATCH_ANALYTICS_PARTITIONING_MEASURE;
         #if defined(SELECTIVE_CC)
-            batches_.push_back(DoDataBasedPartition(batch_idx));
+            SimpleConcurrentWorklist* wl = DoDataBasedPartition(batch_idx);
         #else
-            batches_.push_back(DoSimplePartition(batch_idx));
+            SimpleConcurrentWorklist* wl = DoSimplePartition(batch_idx);
         #endif
+        END_BATCH_ANALYTICS_PARTITIONING_MEASURE(batch_idx);
+        if(is_hidden) {
+            END_HIDDEN_PARTITIONING_TIME_MEASURE(0);
+        } else {
+            END_PARTITIONING_TIME_MEASURE(0);
+        }
+
+        PrepareWorklist(batch_idx, wl);
+        SimpleConcurrentWorklist* retired = batches_.Publish(batch_idx, wl);
+        if(retired != NULL) {
+            RetireWorklist(retired);
+        }
     }
-    END_PARTITIONING_TIME_MEASURE(0);
 
-    std::cout << "done with scheduler initial run..." << std::endl;
-    executor_->is_scheduler_ready_ = true;
+    if(initial_batch_count == num_batches_) {
+        std::cout << "done with scheduler initial run..." << std::endl;
+        START_BATCH_ANALYTICS;
+        executor_->is_scheduler_ready_ = true;
+    }
+
+    if(partitioner_ != NULL) {
+        partitioner_->Stop();
+        delete partitioner_;
+        partitioner_ = NULL;
+    }
+    #if defined(RECONNAISSANCE)
+        for(auto iter = reconnaissances_.begin(); iter != reconnaissances_.end(); iter++) {
+            delete *iter;
+        }
+        reconnaissances_.clear();
+    #endif
+}
+
+//all atomic-batches of a retired super-batch have been executed, so the
+//worklist and its atomic-batches can be freed. Parameters are not owned here.
+void SharedWorklistScheduler::RetireWorklist(SimpleConcurrentWorklist* wl) {
+    for(auto iter = wl->queue_.begin(); iter != wl->queue_.end(); iter++) {
+        delete *iter;
+    }
+    for(auto lane_iter = wl->lanes_.begin(); lane_iter != wl->lanes_.end(); lane_iter++) {
+        for(auto iter = lane_iter->begin(); iter != lane_iter->end(); iter++) {
+            delete *iter;
+        }
+    }
+    if(wl->graph_ != NULL) {
+        delete wl->graph_;
+        wl->graph_ = NULL;
+    }
+    delete wl;
 }
 
 SimpleConcurrentWorklist* SharedWorklistScheduler::DoSimplePartition(int batch_idx) {
@@ -81,50 +223,470 @@ SimpleConcurrentWorklist* SharedWorklistScheduler::DoSimplePartition(int batch_i
         }
         
     }
+    wl->remaining_count_.store(wl->queue_.size());
+    #if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+        AnalyzeAtomicBatches(batch_idx, wl);
+    #endif
     return wl;
 }
 
 SimpleConcurrentWorklist* SharedWorklistScheduler::DoDataBasedPartition(int batch_idx) {
-    std::unordered_set<TxnParam*> clusters;
-    ReadWriteSet batch_rw_set;
-    
-    /* Step 1: Create singleton clusters and build read-write sets of txn */
+    std::vector<TxnParam*> txns;
     for(int i = 0; i < thread_count_; i++) {
         ParamBatch* thread_param_batch = (*raw_batches_[i])[batch_idx];
         if(thread_param_batch != NULL) {
             int size = thread_param_batch->size();
             for(int j = 0; j < size; j++) {
-                TxnParam* txn = thread_param_batch->get(j);
-                txn->BuildReadWriteSet(batch_rw_set);
-                clusters.insert(txn);
+                txns.push_back(thread_param_batch->get(j));
             }
             delete thread_param_batch;
         }
     }
 
-    size_t num_txns = clusters.size();
-    size_t num_items = batch_rw_set.lookup_.size();
-    size_t num_contention_items = 0;
-    double average_contention = 0.0, contention_ratio = 0.0;
+    //super-batch (batch_idx - capacity) has retired, so the arenas of its slot can be recycled
+    BumpArena** arenas = &arenas_[(batch_idx % batches_.Capacity()) * GetPartitionThreadCount()];
+    for(size_t i = 0; i < GetPartitionThreadCount(); i++) {
+        arenas[i]->Reset();
+    }
+
+    PartitionStatistics stats;
+    std::vector<TxnParam*> clustered_txns(txns.size());
+    std::vector<TxnCluster> clusters;
+    if(partitioner_ != NULL) {
+        partitioner_->Cluster(txns, arenas, clustered_txns.data(), clusters, stats);
+    } else {
+        DoSerialClustering(txns, arenas[0], clustered_txns.data(), clusters, stats);
+    }
+
+    //remember which items this super-batch touches, so that the next one can tell which of its
+    //clusters may start before this one completes. The footprint lives in the arenas of the slot.
+    ReadWriteSet& footprint = footprints_[batch_idx % batches_.Capacity()];
+    footprint.Reset(arenas[0]);
+    for(auto iter = txns.begin(); iter != txns.end(); iter++) {
+        ReadWriteSet& rw_set = (*iter)->GetReadWriteSet();
+        for(auto rw_iter = rw_set.begin(); rw_iter != rw_set.end(); rw_iter++) {
+            footprint.Add(rw_iter->hash_, rw_iter->info_);
+        }
+    }
+
+    ConcurrencyControlType type = CC_LOCK_WAIT;
+    #if defined(DYNAMIC_CC)
+        type = cc_policy_->Select(batch_idx, stats);
+        cc_feedback_.RecordDecision(batch_idx, type, stats);
+    #endif
+    #if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+        AnalyzeClusters(batch_idx, clusters, stats, type);
+    #endif
+
+    #if defined(DEPENDENCY_GRAPH_EXECUTION)
+        DependencyGraph* graph = ExtractDependencyGraph(txns, clusters, type);
+    #endif
+
+    //clusters that do not conflict with the previous super-batch go first, they may start early
+    auto late_begin = clusters.begin();
+    if(batch_idx > 0) {
+        ReadWriteSet& previous_footprint = footprints_[(batch_idx - 1) % batches_.Capacity()];
+        late_begin = std::stable_partition(clusters.begin(), clusters.end(), [&](const TxnCluster& cluster) {
+            return !ConflictsWith(cluster, previous_footprint);
+        });
+    }
+
+    #if defined(COST_AWARE_PACKING)
+        txn_cost_model_.Refresh();
+    #endif
+    SimpleConcurrentWorklist* wl = new SimpleConcurrentWorklist();
+    #if defined(HOT_KEY_DELEGATION)
+        ExtractHotLanes(clusters, type, wl);
+    #endif
+    PackAtomicBatches(clusters.begin(), late_begin, type, wl->queue_);
+    wl->early_count_ = wl->queue_.size();
+    PackAtomicBatches(late_begin, clusters.end(), type, wl->queue_);
+    wl->remaining_count_.store(wl->queue_.size());
+    #if defined(DEPENDENCY_GRAPH_EXECUTION)
+        wl->graph_ = graph;
+    #endif
+    #if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+        AnalyzeAtomicBatches(batch_idx, wl);
+    #endif
+    return wl;
+}
+
+#if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+//before hot lanes and the dependency graph take their clusters away
+void SharedWorklistScheduler::AnalyzeClusters(int batch_idx, const std::vector<TxnCluster>& clusters, const PartitionStatistics& stats, const ConcurrencyControlType& type) {
+    BatchAnalyticsRecord& record = batch_analytics_->GetRecord(batch_idx);
+    record.num_txns_ = stats.num_txns_;
+    record.num_items_ = stats.num_items_;
+    record.num_contention_items_ = stats.num_contention_items_;
+    record.cc_type_ = type;
+    for(auto iter = clusters.begin(); iter != clusters.end(); iter++) {
+        record.AddCluster(iter->size_);
+        for(size_t i = 0; i < iter->size_; i++) {
+            ReadWriteSet& rw_set = iter->members_[i]->GetReadWriteSet();
+            for(auto rw_iter = rw_set.begin(); rw_iter != rw_set.end(); rw_iter++) {
+                record.num_accesses_++;
+                if(rw_iter->info_->avoid_cc_) {
+                    record.num_avoid_cc_accesses_++;
+                }
+            }
+        }
+    }
+}
+
+void SharedWorklistScheduler::AnalyzeAtomicBatches(int batch_idx, SimpleConcurrentWorklist* wl) {
+    BatchAnalyticsRecord& record = batch_analytics_->GetRecord(batch_idx);
+    std::vector<ParamBatch*> batches(wl->queue_);
+    for(auto lane_iter = wl->lanes_.begin(); lane_iter != wl->lanes_.end(); lane_iter++) {
+        batches.insert(batches.end(), lane_iter->begin(), lane_iter->end());
+    }
+    record.num_atomic_batches_ = batches.size();
+    for(auto iter = batches.begin(); iter != batches.end(); iter++) {
+        record.num_batched_txns_ += (*iter)->size();
+        record.max_atomic_batch_size_ = std::max(record.max_atomic_batch_size_, (*iter)->size());
+    }
+    if(record.num_txns_ == 0) {
+        //without SELECTIVE_CC there are no clusters
+        record.num_txns_ = record.num_batched_txns_;
+    }
+}
+#endif
+
+//hot items are grouped into lanes, two hot items share a lane if a cluster touches both. every
+//cluster touching a hot item is moved out of clusters and into the lane of its hot items, and each
+//lane is given to one worker, so that the hot items are only ever accessed by their owner.
+void SharedWorklistScheduler::ExtractHotLanes(std::vector<TxnCluster>& clusters, const ConcurrencyControlType& type, SimpleConcurrentWorklist* wl) {
+    std::unordered_map<BatchAccessInfo*, size_t> hot_item_ids;
+    std::vector<BatchAccessInfo*> hot_items;
+    std::vector<size_t> parents;
+    std::vector<long long> cluster_lanes(clusters.size(), -1);
+    auto find = [&parents](size_t id) {
+        while(parents[id] != id) {
+            parents[id] = parents[parents[id]];
+            id = parents[id];
+        }
+        return id;
+    };
+
+    for(size_t c = 0; c < clusters.size(); c++) {
+        TxnCluster& cluster = clusters[c];
+        for(size_t i = 0; i < cluster.size_; i++) {
+            ReadWriteSet& rw_set = cluster.members_[i]->GetReadWriteSet();
+            for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+                BatchAccessInfo* info = iter->info_;
+                if(info->avoid_cc_ || info->txns_.size() < HOT_ITEM_THRESHOLD) {
+                    continue;
+                }
+                auto id_iter = hot_item_ids.find(info);
+                size_t id;
+                if(id_iter == hot_item_ids.end()) {
+                    id = hot_items.size();
+                    hot_item_ids[info] = id;
+                    hot_items.push_back(info);
+                    parents.push_back(id);
+                } else {
+                    id = id_iter->second;
+                }
+                if(cluster_lanes[c] < 0) {
+                    cluster_lanes[c] = id;
+                } else {
+                    parents[find(id)] = find(cluster_lanes[c]);
+                }
+            }
+        }
+    }
+    if(hot_items.empty()) {
+        return;
+    }
+
+    //lanes go to the least loaded worker, biggest lane first
+    std::unordered_map<size_t, size_t> lane_sizes;
+    for(size_t c = 0; c < clusters.size(); c++) {
+        if(cluster_lanes[c] >= 0) {
+            cluster_lanes[c] = find(cluster_lanes[c]);
+            lane_sizes[cluster_lanes[c]] += clusters[c].size_;
+        }
+    }
+    std::vector<std::pair<size_t, size_t>> sorted_lanes(lane_sizes.begin(), lane_sizes.end());
+    std::sort(sorted_lanes.begin(), sorted_lanes.end(), 
+        [](const std::pair<size_t, size_t>& l1, const std::pair<size_t, size_t>& l2) { return l1.second > l2.second; });
+    std::vector<size_t> thread_loads(thread_count_, 0);
+    std::unordered_map<size_t, size_t> lane_owners;
+    for(auto iter = sorted_lanes.begin(); iter != sorted_lanes.end(); iter++) {
+        size_t owner = std::min_element(thread_loads.begin(), thread_loads.end()) - thread_loads.begin();
+        thread_loads[owner] += iter->second;
+        lane_owners[iter->first] = owner;
+    }
+
+    std::vector<std::vector<TxnCluster>> owner_clusters(thread_count_);
+    std::vector<TxnCluster> shared_clusters;
+    for(size_t c = 0; c < clusters.size(); c++) {
+        if(cluster_lanes[c] >= 0) {
+            owner_clusters[lane_owners[cluster_lanes[c]]].push_back(clusters[c]);
+        } else {
+            shared_clusters.push_back(clusters[c]);
+        }
+    }
+    clusters.swap(shared_clusters);
+
+    wl->lanes_.resize(thread_count_);
+    wl->lane_next_idx_.resize(thread_count_, 0);
+    for(size_t i = 0; i < thread_count_; i++) {
+        PackAtomicBatches(owner_clusters[i].begin(), owner_clusters[i].end(), type, wl->lanes_[i]);
+    }
+    //only the owner executes the lane, one atomic-batch after the other
+    for(auto iter = hot_items.begin(); iter != hot_items.end(); iter++) {
+        (*iter)->avoid_cc_ = true;
+    }
+}
+
+//moves every cluster that accesses a contended item out of clusters and into a dependency graph.
+//an item shared by two clusters is contended, so the moved transactions share no item with the rest.
+DependencyGraph* SharedWorklistScheduler::ExtractDependencyGraph(const std::vector<TxnParam*>& txns, std::vector<TxnCluster>& clusters, const ConcurrencyControlType& type) {
+    auto graph_begin = std::stable_partition(clusters.begin(), clusters.end(), [](const TxnCluster& cluster) {
+        for(size_t i = 0; i < cluster.size_; i++) {
+            ReadWriteSet& rw_set = cluster.members_[i]->GetReadWriteSet();
+            for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+                if(!iter->info_->avoid_cc_) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+    if(graph_begin == clusters.end()) {
+        return NULL;
+    }
+
+    //data_ is free after clustering, use it to mark the graph transactions
+    for(auto iter = graph_begin; iter != clusters.end(); iter++) {
+        for(size_t i = 0; i < iter->size_; i++) {
+            iter->members_[i]->data_ = (char*)iter->members_[i];
+        }
+    }
+    //keep the submission order, which makes execution deterministic
+    std::vector<TxnParam*> graph_txns;
+    for(auto iter = txns.begin(); iter != txns.end(); iter++) {
+        if((*iter)->data_ != NULL) {
+            graph_txns.push_back(*iter);
+            (*iter)->data_ = NULL;
+        }
+    }
+    clusters.erase(graph_begin, clusters.end());
+    return new DependencyGraph(graph_txns, type);
+}
+
+bool SharedWorklistScheduler::ConflictsWith(const TxnCluster& cluster, const ReadWriteSet& footprint) {
+    for(size_t i = 0; i < cluster.size_; i++) {
+        ReadWriteSet& rw_set = cluster.members_[i]->GetReadWriteSet();
+        for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+            BatchAccessInfo* previous_info = footprint.Get(iter->hash_);
+            //reads of both super-batches do not conflict
+            if(previous_info != NULL && (previous_info->has_writes_ || iter->info_->has_writes_)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+#if defined(COST_AWARE_PACKING)
+/* Step 4: now we use the produced clusters to partition the super-batch into 
+atomic-batches of size atmost MAX_ATOMIC_BATCH_SIZE. Clusters are weighed with
+the learned procedure costs and packed longest processing time first: each one
+goes to the cheapest atomic-batch that still has room. Atomic-batches are then
+handed out most expensive first, so that workers finish at about the same time.*/
+void SharedWorklistScheduler::PackAtomicBatches(std::vector<TxnCluster>::iterator begin, std::vector<TxnCluster>::iterator end, const ConcurrencyControlType& type, std::vector<ParamBatch*>& batches) {
+    std::vector<std::pair<double, TxnCluster*>> weighted_clusters;
+    size_t total_size = 0;
+    for(auto iter = begin; iter != end; iter++) {
+        double cost = 0.0;
+        for(size_t i = 0; i < iter->size_; i++) {
+            cost += txn_cost_model_.GetCost(iter->members_[i]->type_);
+        }
+        weighted_clusters.push_back(std::make_pair(cost, &(*iter)));
+        total_size += iter->size_;
+    }
+    if(weighted_clusters.empty()) {
+        return;
+    }
+    std::sort(weighted_clusters.begin(), weighted_clusters.end(), 
+        [](const std::pair<double, TxnCluster*>& c1, const std::pair<double, TxnCluster*>& c2) { return c1.first > c2.first; });
+
+    //same number of atomic-batches as greedy filling would need at best
+    size_t batch_count = (total_size + MAX_ATOMIC_BATCH_SIZE - 2) / (MAX_ATOMIC_BATCH_SIZE - 1);
+    std::vector<AtomicBatchBin> bins(batch_count);
+    auto is_cheaper = [&bins](const size_t& b1, const size_t& b2) { return bins[b1].cost_ > bins[b2].cost_; };
+    std::vector<size_t> heap;
+    for(size_t i = 0; i < batch_count; i++) {
+        bins[i].batch_ = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
+        heap.push_back(i);
+    }
+    std::make_heap(heap.begin(), heap.end(), is_cheaper);
+
+    std::vector<size_t> full_bins;
+    for(auto iter = weighted_clusters.begin(); iter != weighted_clusters.end(); iter++) {
+        TxnCluster* cluster = iter->second;
+        //cheapest bin that the cluster fits in, open a new one if none does
+        size_t bin_idx = bins.size();
+        while(!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), is_cheaper);
+            size_t candidate = heap.back();
+            heap.pop_back();
+            if(bins[candidate].size_ + cluster->size_ < MAX_ATOMIC_BATCH_SIZE) {
+                bin_idx = candidate;
+                break;
+            }
+            full_bins.push_back(candidate);
+        }
+        if(bin_idx == bins.size()) {
+            bins.push_back(AtomicBatchBin());
+            bins.back().batch_ = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
+        }
+        AtomicBatchBin& bin = bins[bin_idx];
+        for(size_t i = 0; i < cluster->size_; i++) {
+            bin.batch_->push_back(cluster->members_[i]);
+        }
+        bin.size_ += cluster->size_;
+        bin.cost_ += iter->first;
+
+        //bins that were too full for this cluster may still take smaller ones
+        full_bins.push_back(bin_idx);
+        for(auto bin_iter = full_bins.begin(); bin_iter != full_bins.end(); bin_iter++) {
+            heap.push_back(*bin_iter);
+            std::push_heap(heap.begin(), heap.end(), is_cheaper);
+        }
+        full_bins.clear();
+    }
+
+    std::sort(bins.begin(), bins.end(), 
+        [](const AtomicBatchBin& b1, const AtomicBatchBin& b2) { return b1.cost_ > b2.cost_; });
+    for(auto iter = bins.begin(); iter != bins.end(); iter++) {
+        if(iter->size_ == 0) {
+            delete iter->batch_;
+            continue;
+        }
+        #if defined(DYNAMIC_CC)
+            iter->batch_->cc_type_ = type;
+        #endif
+        batches.push_back(iter->batch_);
+    }
+}
+#else
+/* Step 4: now we use the produced clusters to partition the super-batch into 
+atomic-batches of size atmost MAX_ATOMIC_BATCH_SIZE. Here we greedily fill the
+buckets. We can do slightly better by sorting and distributing appropriately*/
+void SharedWorklistScheduler::PackAtomicBatches(std::vector<TxnCluster>::iterator begin, std::vector<TxnCluster>::iterator end, const ConcurrencyControlType& type, std::vector<ParamBatch*>& batches) {
+    ParamBatch* current_batch = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
+    size_t current_batch_size = 0;
+    for(auto iter = begin; iter != end; iter++) {
+        size_t size_of_cluster = iter->size_;
+        bool can_add_in_same_batch = (current_batch_size + size_of_cluster) < MAX_ATOMIC_BATCH_SIZE;
+
+        if(!can_add_in_same_batch && current_batch_size > 0) {
+            #if defined(DYNAMIC_CC)
+            current_batch->cc_type_ = type;
+            #endif
+            batches.push_back(current_batch);
+            current_batch = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
+            current_batch_size = 0;
+        }
+        
+        for(size_t i = 0; i < size_of_cluster; i++) {
+            current_batch->push_back(iter->members_[i]);
+            current_batch_size++;
+        }
+    }
+    //adding last batch
+    if(current_batch_size > 0) {
+        #if defined(DYNAMIC_CC)
+            current_batch->cc_type_ = type;
+        #endif
+        batches.push_back(current_batch);
+    } else {
+        delete current_batch;
+    }
+}
+#endif
+
+void SharedWorklistScheduler::DoSerialClustering(std::vector<TxnParam*>& txns, BumpArena* arena, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats) {
+    std::unordered_set<TxnParam*> cluster_heads;
+    ReadWriteSet batch_rw_set;
+    batch_rw_set.Reset(arena);
+    
+    /* Step 1: Create singleton clusters and build read-write sets of txn */
+    for(auto iter = txns.begin(); iter != txns.end(); iter++) {
+        TxnParam* txn = *iter;
+        #if defined(RECONNAISSANCE)
+            reconnaissances_[0]->BuildReadWriteSet(txn, batch_rw_set);
+        #else
+            if(!txn->BuildReadWriteSet(batch_rw_set)) {
+                //the items of txn are only found by a reconnaissance run
+                assert(false);
+            }
+        #endif
+        cluster_heads.insert(txn);
+    }
+
+    stats.num_txns_ = cluster_heads.size();
+    stats.num_items_ = batch_rw_set.size();
 
     std::unordered_set<BatchAccessInfo*> interesting_items;
     size_t max_progress = 0;
+    #if defined(INCREMENTAL_PARTITIONING)
+        //interesting items the previous super-batch merged, and what this one decides for its items
+        std::vector<BatchAccessInfo*> carried_items;
+        std::unordered_map<int64_t, ItemHistory> next_item_history;
+    #endif
     /* Step 2: Collect all interesting data items. Interesting data
     items are those that are accessed by more than one transaction */
-    for(auto iter = batch_rw_set.lookup_.begin(); iter != batch_rw_set.lookup_.end(); iter++) {
-        BatchAccessInfo* info = iter->second;
+    for(auto iter = batch_rw_set.begin(); iter != batch_rw_set.end(); iter++) {
+        BatchAccessInfo* info = iter->info_;
         size_t size = info->txns_.size();
         if(size > 1 && size < MAX_ATOMIC_BATCH_SIZE) {
+        #if defined(INCREMENTAL_PARTITIONING)
+            auto history = item_history_.find(info->hash_);
+            if(history != item_history_.end()) {
+                ItemHistory& item_history = next_item_history[info->hash_];
+                item_history = history->second;
+                item_history.degree_ = (item_history.degree_ + size) / 2;
+                if(item_history.is_contended_ && size * 2 >= history->second.degree_) {
+                    //still about as hot as when it could not be merged, it will not fit this time either
+                    stats.total_contention_ += item_history.cluster_size_;
+                    stats.num_contention_items_++;
+                    continue;
+                }
+                if(!item_history.is_contended_) {
+                    carried_items.push_back(info);
+                }
+            }
+        #endif
             interesting_items.insert(info);
             max_progress = std::max(max_progress, info->txns_.size());
         } else if(size == 1) {
             info->avoid_cc_ = true;
         } else if(size >= MAX_ATOMIC_BATCH_SIZE) {
-            num_contention_items++;
-            average_contention += size;
+            stats.num_contention_items_++;
+            stats.total_contention_ += size;
         }
     }
 
+    #if defined(INCREMENTAL_PARTITIONING)
+        /* Step 2a: Rebuild the clusters of the hot set first, in the order of their degree, so that
+        only the items new to this super-batch go through the rounds below */
+        std::sort(carried_items.begin(), carried_items.end(), compare_degree);
+        for(auto iter = carried_items.begin(); iter != carried_items.end(); iter++) {
+            BatchAccessInfo* info = *iter;
+            size_t degree = info->txns_.size();
+            size_t resulting_cluster_size = MergeItemClusters(info, cluster_heads);
+            if(!info->avoid_cc_) {
+                stats.total_contention_ += resulting_cluster_size;
+                stats.num_contention_items_++;
+            }
+            interesting_items.erase(info);
+            RecordItemHistory(next_item_history, info, degree, resulting_cluster_size);
+        }
+    #endif
+
     /* Step 3: Iteratively cluster txns grouped by data items from the interesting_items set. 
     Progress indicator ensures that the loop terminates. We look at every data item
     only once and merge them if the size constraints are satisfied */
@@ -132,6 +694,7 @@ SimpleConcurrentWorklist* SharedWorklistScheduler::DoDataBasedPartition(int batc
     std::vector<BatchAccessInfo*> targets;
     while(progress <= max_progress) {
         //collect target items for this round
+        targets.clear();
         for(auto iter = interesting_items.begin(); iter != interesting_items.end(); iter++) {
             BatchAccessInfo* info = (*iter);
             if(info->txns_.size() <= progress) {
@@ -142,120 +705,238 @@ SimpleConcurrentWorklist* SharedWorklistScheduler::DoDataBasedPartition(int batc
         //for each target item, try to merge them into a cluster
         for(auto iter = targets.begin(); iter != targets.end(); iter++) {
             BatchAccessInfo* info = *iter;
-            
-            //find resulting cluster size, if we merge clusters of this data item
-            size_t resulting_cluster_size = 0;
-            for(auto txn_iter = info->txns_.begin(); txn_iter != info->txns_.end(); txn_iter++) {
-                TxnParam* txn = *txn_iter;
-                if(txn->data_ != NULL) {
-                    resulting_cluster_size += ((ClusterInfo*)txn->data_)->GetSize();
-                } else {
-                    resulting_cluster_size++;
-                }
-            }
-
-            if(resulting_cluster_size < MAX_ATOMIC_BATCH_SIZE) {
-                while(info->txns_.size() > 1) {
-                    auto iter = info->txns_.begin();
-                    auto t1 = *iter; 
-                    iter++;
-                    auto t2 = *iter;
-                    auto merged = ClusterInfo::Merge(t1, t2);
-                    if(merged == t1) {
-                        clusters.erase(t2);
-                    } else {
-                        clusters.erase(t1);
-                    }
-                }
-                info->avoid_cc_ = true;
-                interesting_items.erase(info);
-            } else {
-                //remove from interesting items so that we don't get it again
-                average_contention += resulting_cluster_size;
-                interesting_items.erase(info);
-                num_contention_items++;
+            #if defined(INCREMENTAL_PARTITIONING)
+                //read before the merge, which may change txns_
+                size_t degree = info->txns_.size();
+            #endif
+            size_t resulting_cluster_size = MergeItemClusters(info, cluster_heads);
+            if(!info->avoid_cc_) {
+                stats.total_contention_ += resulting_cluster_size;
+                stats.num_contention_items_++;
             }
+            //remove from interesting items so that we don't get it again
+            interesting_items.erase(info);
+            #if defined(INCREMENTAL_PARTITIONING)
+                RecordItemHistory(next_item_history, info, degree, resulting_cluster_size);
+            #endif
         }
         progress++;
     }
-
-    #if defined(DYNAMIC_CC)
-        ConcurrencyControlType type;
-        if(num_contention_items > 0) {
-            average_contention /= num_contention_items;
-            contention_ratio = (double)num_contention_items / (double)num_items;
-            if(contention_ratio < 0.2 && average_contention < 25) {
-                type = CC_OCC;
-                std::cout << "batch idx : " << batch_idx << " cc : OCC" << std::endl;
-            } else {
-                type = CC_LOCK_WAIT;
-                std::cout << "batch idx : " << batch_idx << " cc : 2PL" << std::endl;
-            }
-        } else {
-            type = CC_OCC;
-            std::cout << "batch idx : " << batch_idx <<" cc : OCC" << std::endl;
-        } 
+    #if defined(INCREMENTAL_PARTITIONING)
+        //items the workload stopped touching are forgotten
+        item_history_.swap(next_item_history);
     #endif
 
-    /* Step 4: now we use the produced clusters to partition the super-batch into 
-    atomic-batches of size atmost MAX_ATOMIC_BATCH_SIZE. Here we greedily fill the
-    buckets. We can do slightly better by sorting and distributing appropriately*/
-
-    //int num_atomic_batches = (num_txns / MAX_ATOMIC_BATCH_SIZE) + 1;
-    SimpleConcurrentWorklist* wl = new SimpleConcurrentWorklist();
-    
-    ParamBatch* current_batch = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
-    size_t current_batch_size = 0;
-    for(auto iter = clusters.begin(); iter != clusters.end(); iter++) {
+    //lay the clusters out contiguously, dropping the ClusterInfos
+    size_t offset = 0;
+    for(auto iter = cluster_heads.begin(); iter != cluster_heads.end(); iter++) {
         TxnParam* param = *iter;
-        size_t size_of_cluster = param->data_ == NULL ? 1 : ((ClusterInfo*)param->data_)->GetSize();
-        bool can_add_in_same_batch = (current_batch_size + size_of_cluster) < MAX_ATOMIC_BATCH_SIZE;
-
-        if(!can_add_in_same_batch) {
-            #if defined(DYNAMIC_CC)
-            current_batch->cc_type_ = type;
-            #endif
-            wl->Add(current_batch);
-            current_batch = new ParamBatch(MAX_ATOMIC_BATCH_SIZE);
-            current_batch_size = 0;
-        }
-        
         if(param->data_ == NULL) {
-            current_batch->push_back(param);
-            current_batch_size++;
+            clustered_txns[offset] = param;
+            clusters.push_back(TxnCluster(clustered_txns + offset, 1));
+            offset++;
         } else {
             ClusterInfo* info = (ClusterInfo*)param->data_;
             for(auto txn_iter = info->members_.begin(); txn_iter != info->members_.end(); txn_iter++) {
-                current_batch->push_back(*iter);
-                current_batch_size++;
+                clustered_txns[offset + (txn_iter - info->members_.begin())] = *txn_iter;
             }
+            clusters.push_back(TxnCluster(clustered_txns + offset, info->GetSize()));
+            offset += info->GetSize();
             delete info;
+            param->data_ = NULL;
         }
     }
-    //adding last batch
-    #if defined(DYNAMIC_CC)
-        current_batch->cc_type_ = type;
-    #endif
-    wl->Add(current_batch);
-    return wl;
+    assert(offset == txns.size());
+}
+
+//merges the clusters of the transactions accessing info unless the result would be too big for an
+//atomic-batch, in which case info keeps its concurrency control. Returns the size of the result.
+size_t SharedWorklistScheduler::MergeItemClusters(BatchAccessInfo* info, std::unordered_set<TxnParam*>& cluster_heads) {
+    size_t resulting_cluster_size = 0;
+    for(auto txn_iter = info->txns_.begin(); txn_iter != info->txns_.end(); txn_iter++) {
+        TxnParam* txn = *txn_iter;
+        if(txn->data_ != NULL) {
+            resulting_cluster_size += ((ClusterInfo*)txn->data_)->GetSize();
+        } else {
+            resulting_cluster_size++;
+        }
+    }
+
+    if(resulting_cluster_size < MAX_ATOMIC_BATCH_SIZE) {
+        while(info->txns_.size() > 1) {
+            auto iter = info->txns_.begin();
+            auto t1 = *iter; 
+            iter++;
+            auto t2 = *iter;
+            auto merged = ClusterInfo::Merge(t1, t2);
+            if(merged == t1) {
+                cluster_heads.erase(t2);
+            } else {
+                cluster_heads.erase(t1);
+            }
+        }
+        info->avoid_cc_ = true;
+    }
+    return resulting_cluster_size;
 }
 
+#if defined(INCREMENTAL_PARTITIONING)
+//degree is the number of transactions that accessed info before its clusters were merged
+void SharedWorklistScheduler::RecordItemHistory(std::unordered_map<int64_t, ItemHistory>& item_history, BatchAccessInfo* info, const size_t& degree, const size_t& cluster_size) {
+    auto iter = item_history.find(info->hash_);
+    if(iter == item_history.end()) {
+        //new to the hot set, otherwise the estimate was already updated while collecting the items
+        iter = item_history.insert(std::make_pair(info->hash_, ItemHistory((double)degree))).first;
+    }
+    iter->second.cluster_size_ = cluster_size;
+    iter->second.is_contended_ = !info->avoid_cc_;
+}
+#endif
+
 ParamBatch* SharedWorklistScheduler::GetNextBatch(const size_t& thread_id) {
+#if defined(CONTINUOUS_BATCH_EXECUTION)
+    //the atomic-batch this thread asked for last time has been executed
+    int held_batch_idx = held_batch_idx_[thread_id];
+    if(held_batch_idx >= 0) {
+        if(batches_.Get(held_batch_idx)->remaining_count_.fetch_sub(1) == 1) {
+            AdvanceCompletedBatchCount();
+        }
+        held_batch_idx_[thread_id] = -1;
+    }
+#endif
+#if defined(DEPENDENCY_GRAPH_EXECUTION)
+    //the graph transaction this thread asked for last time has been executed. the barrier
+    //cannot be passed before that, so it belongs to the current super-batch
+    if(held_graph_node_[thread_id] >= 0) {
+        batches_.Get(current_batch_idx_.load())->graph_->Complete(held_graph_node_[thread_id]);
+        held_graph_node_[thread_id] = -1;
+    }
+#endif
     int current_batch_idx = current_batch_idx_.load();
-    if(current_batch_idx < batches_.size()) {
+    if(current_batch_idx < num_batches_) {
+        SimpleConcurrentWorklist* wl = batches_.Get(current_batch_idx);
+        if(wl == NULL) {
+            //partitioner has not caught up with the workers yet
+            BEGIN_PARTITIONING_STALL_TIME_MEASURE(thread_id);
+            while((wl = batches_.Get(current_batch_idx)) == NULL);
+            END_PARTITIONING_STALL_TIME_MEASURE(thread_id);
+        }
+    #if defined(CONTINUOUS_BATCH_EXECUTION)
+        int next_idx = wl->next_idx_.fetch_add(1);
+        if(next_idx < (int)wl->queue_.size()) {
+            if(next_idx >= (int)wl->early_count_) {
+                //late atomic-batches may conflict with the previous super-batch
+                WaitForCompletedBatchCount(thread_id, current_batch_idx);
+            } else {
+                //early ones were only checked against the previous super-batch, so the one
+                //before it must be gone
+                WaitForCompletedBatchCount(thread_id, current_batch_idx - 1);
+            }
+            held_batch_idx_[thread_id] = current_batch_idx;
+            return wl->queue_[next_idx];
+        } else {
+            //every atomic-batch has been handed out, move on without waiting for them to finish
+            current_batch_idx_.compare_exchange_strong(current_batch_idx, current_batch_idx + 1);
+            AdvanceCompletedBatchCount();
+            return GetNextBatch(thread_id);
+        }
+    #else
+    #if defined(DEPENDENCY_GRAPH_EXECUTION)
+        if(wl->graph_ != NULL) {
+            ParamBatch* batch = GetNextGraphBatch(thread_id, wl->graph_, false);
+            if(batch != NULL) {
+                return batch;
+            }
+        }
+    #endif
+    #if defined(HOT_KEY_DELEGATION)
+        //the lane of this worker holds the hot items, nobody else can make progress on it
+        if(!wl->lanes_.empty() && wl->lane_next_idx_[thread_id] < wl->lanes_[thread_id].size()) {
+            return wl->lanes_[thread_id][wl->lane_next_idx_[thread_id]++];
+        }
+    #endif
         //current super-batch is active : try getting from current super-batch
-        ParamBatch* batch = batches_[current_batch_idx]->GetNext();
+        ParamBatch* batch = wl->GetNext();
         if(batch != NULL) {
             return batch;
         } else {
-            SynchronizeBatchExecution(thread_id);
+        #if defined(DEPENDENCY_GRAPH_EXECUTION)
+            if(wl->graph_ != NULL) {
+                //atomic-batches are gone, help draining the graph
+                batch = GetNextGraphBatch(thread_id, wl->graph_, true);
+                if(batch != NULL) {
+                    return batch;
+                }
+            }
+        #endif
+            ParamBatch* deferred_batch = SynchronizeBatchExecution(thread_id);
+            if(deferred_batch != NULL) {
+                return deferred_batch;
+            }
             return GetNextBatch(thread_id);
         }
+    #endif
     } else {
         return NULL;
     }
 }
 
+#if defined(DEPENDENCY_GRAPH_EXECUTION)
+//with wait_for_done, spins until a transaction is ready or the whole graph has been executed
+ParamBatch* SharedWorklistScheduler::GetNextGraphBatch(const size_t& thread_id, DependencyGraph* graph, bool wait_for_done) {
+    do {
+        size_t node_idx;
+        ParamBatch* batch = graph->GetReady(node_idx);
+        if(batch != NULL) {
+            held_graph_node_[thread_id] = node_idx;
+            return batch;
+        }
+    } while(wait_for_done && !graph->IsDone());
+    return NULL;
+}
+#endif
+
+int SharedWorklistScheduler::GetCompletedBatchCount() const {
+#if defined(CONTINUOUS_BATCH_EXECUTION)
+    return completed_batch_count_.load();
+#else
+    //the barrier only lets the workers move on once the super-batch has completed
+    return current_batch_idx_.load();
+#endif
+}
+
+#if defined(CONTINUOUS_BATCH_EXECUTION)
+//super-batches complete in order, even though a later one may drain first
+void SharedWorklistScheduler::AdvanceCompletedBatchCount() {
+    int completed_count = completed_batch_count_.load();
+    while(completed_count < num_batches_) {
+        SimpleConcurrentWorklist* wl = batches_.Get(completed_count);
+        if(wl == NULL || wl->remaining_count_.load() != 0) {
+            return;
+        }
+        //on failure completed_count is reloaded and we retry from there
+        if(completed_batch_count_.compare_exchange_weak(completed_count, completed_count + 1)) {
+            #if defined(DYNAMIC_CC)
+                cc_feedback_.CompleteBatch(completed_count);
+            #endif
+            COMPLETE_BATCH_ANALYTICS(completed_count);
+            completed_count++;
+        }
+    }
+}
+
+void SharedWorklistScheduler::WaitForCompletedBatchCount(const size_t& thread_id, const int& count) {
+    if(completed_batch_count_.load() >= count) {
+        return;
+    }
+    BEGIN_BATCH_SYNC_TIME_MEASURE(thread_id);
+    while(completed_batch_count_.load() < count) {
+        AdvanceCompletedBatchCount();
+    }
+    END_BATCH_SYNC_TIME_MEASURE(thread_id);
+}
+#endif
+
 bool compare_degree(BatchAccessInfo* info1, BatchAccessInfo* info2) {
     return info1->txns_.size() < info2->txns_.size();
 }
\ No newline at end of file
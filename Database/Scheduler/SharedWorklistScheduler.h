@@ -11,14 +11,51 @@
 #include "../Logger/BaseLogger.h"
 #include "../Profiler/BatchSyncTimeProfiler.h"
 #include "../Profiler/PartitioningTimeProfiler.h"
+#include "../Profiler/BatchAnalyticsProfiler.h"
 #include "BaseScheduler.h"
 #include "AccessInfo.h"
+#include "TxnCostModel.h"
+#include "DependencyGraph.h"
+#include "CCPolicy.h"
+#include "MultilevelPartitioner.h"
+#if defined(PARALLEL_PARTITIONING)
+#include "ParallelPartitioner.h"
+#endif
+#if defined(RECONNAISSANCE)
+#include "Reconnaissance.h"
+#endif
 #include <vector>
+#include <unordered_map>
 #include <cmath>
 
+#if defined(DEPENDENCY_GRAPH_EXECUTION) && (defined(CONTINUOUS_BATCH_EXECUTION) || defined(WORK_STEALING_SCHEDULER))
+#error "DEPENDENCY_GRAPH_EXECUTION is only supported by the strict SHARED_WORKLIST_SCHEDULER"
+#endif
+#if defined(HOT_KEY_DELEGATION) && (defined(CONTINUOUS_BATCH_EXECUTION) || defined(WORK_STEALING_SCHEDULER))
+#error "HOT_KEY_DELEGATION is only supported by the strict SHARED_WORKLIST_SCHEDULER"
+#endif
+#if defined(HOT_KEY_DELEGATION) && defined(DEPENDENCY_GRAPH_EXECUTION)
+#error "HOT_KEY_DELEGATION cannot be combined with DEPENDENCY_GRAPH_EXECUTION"
+#endif
+#if defined(COST_AWARE_PACKING) && !defined(PIPELINED_PARTITIONING)
+#error "COST_AWARE_PACKING requires PIPELINED_PARTITIONING, otherwise every super-batch is packed before any procedure is measured"
+#endif
+#if defined(ADAPTIVE_CC_POLICY) && !(defined(DYNAMIC_CC) && defined(PIPELINED_PARTITIONING))
+#error "ADAPTIVE_CC_POLICY requires DYNAMIC_CC and PIPELINED_PARTITIONING, otherwise every super-batch gets its protocol before any outcome is observed"
+#endif
+#if defined(INCREMENTAL_PARTITIONING) && (!defined(SELECTIVE_CC) || defined(PARALLEL_PARTITIONING))
+#error "INCREMENTAL_PARTITIONING is only supported by the serial clustering of SELECTIVE_CC"
+#endif
+#if defined(RECONNAISSANCE) && (defined(CONTINUOUS_BATCH_EXECUTION) || !defined(SELECTIVE_CC))
+#error "RECONNAISSANCE is only supported by the strict SHARED_WORKLIST_SCHEDULER with SELECTIVE_CC"
+#endif
+
 #define INITIAL_PRE_PROCESS_BATCH_COUNT 5
+#define LOOKAHEAD_BATCH_COUNT 8
 #define MAX_ATOMIC_BATCH_SIZE 250
-//#define ANALYZE_BATCH
+//items accessed by at least this many transactions of a super-batch get an owner thread. clustering
+//does not merge such items, so their transactions are spread over clusters unless an owner gathers them
+#define HOT_ITEM_THRESHOLD MAX_ATOMIC_BATCH_SIZE
 
 namespace Cavalia{
 	namespace Database{
@@ -28,8 +65,17 @@ namespace Cavalia{
         {
             std::vector<ParamBatch*> queue_;
             std::atomic<int> next_idx_;
+            //the first early_count_ atomic-batches do not conflict with the previous super-batch
+            size_t early_count_;
+            //atomic-batches not executed yet, only tracked in CONTINUOUS_BATCH_EXECUTION
+            std::atomic<int> remaining_count_;
+            //transactions executed in dependency order, only built in DEPENDENCY_GRAPH_EXECUTION
+            DependencyGraph* graph_;
+            //atomic-batches only the owner worker may execute, only built in HOT_KEY_DELEGATION
+            std::vector<std::vector<ParamBatch*>> lanes_;
+            std::vector<size_t> lane_next_idx_;
 
-            SimpleConcurrentWorklist() : queue_(), next_idx_(0) {}
+            SimpleConcurrentWorklist() : queue_(), next_idx_(0), early_count_(0), remaining_count_(0), graph_(NULL), lanes_(), lane_next_idx_() {}
 
             void Add(ParamBatch* item) {
                 queue_.push_back(item);
@@ -44,6 +90,64 @@ namespace Cavalia{
                 }
             }
         };
+
+        //what clustering decided for an item of the hot set in the previous super-batch
+        struct ItemHistory
+        {
+            //moving average of the number of transactions accessing the item
+            double degree_;
+            size_t cluster_size_;
+            bool is_contended_;
+            ItemHistory() : degree_(0.0), cluster_size_(0), is_contended_(false) {}
+            ItemHistory(double degree) : degree_(degree), cluster_size_(0), is_contended_(false) {}
+        };
+
+        //atomic-batch being filled by cost-aware packing
+        struct AtomicBatchBin
+        {
+            ParamBatch* batch_;
+            size_t size_;
+            double cost_;
+            AtomicBatchBin() : batch_(NULL), size_(0), cost_(0.0) {}
+        };
+
+        /*
+        ** Ring of partitioned super-batches. The scheduler thread is the only producer; it publishes
+        ** super-batch idx into slot (idx % capacity) and may only do so once super-batch (idx - capacity)
+        ** has been retired by the workers, which bounds the look-ahead.
+        */
+        struct BoundedWorklistQueue
+        {
+            std::vector<SimpleConcurrentWorklist*> slots_;
+            std::atomic<int> published_count_;
+
+            BoundedWorklistQueue() : slots_(), published_count_(0) {}
+
+            void Reserve(const size_t& capacity) {
+                slots_.resize(capacity, NULL);
+            }
+
+            size_t Capacity() const {
+                return slots_.size();
+            }
+
+            //returns the retired worklist that occupied the slot, if any
+            SimpleConcurrentWorklist* Publish(int batch_idx, SimpleConcurrentWorklist* wl) {
+                size_t slot = batch_idx % slots_.size();
+                SimpleConcurrentWorklist* retired = slots_[slot];
+                slots_[slot] = wl;
+                published_count_.store(batch_idx + 1, std::memory_order_release);
+                return retired;
+            }
+
+            SimpleConcurrentWorklist* Get(int batch_idx) {
+                if(batch_idx < published_count_.load(std::memory_order_acquire)) {
+                    return slots_[batch_idx % slots_.size()];
+                } else {
+                    return NULL;
+                }
+            }
+        };
         
         /*
         ** Class SharedWorklistScheduler:
@@ -56,40 +160,161 @@ namespace Cavalia{
         ** finish processing a super-batch. But, in that case we have to be careful to not use any 
         ** contention-based optimizations such as performing concurrency control only on subset of data 
         ** items that are contentious.
+        **
+        ** With -DPIPELINED_PARTITIONING, the scheduler thread releases the workers after partitioning the
+        ** first INITIAL_PRE_PROCESS_BATCH_COUNT super-batches and keeps partitioning the rest while they 
+        ** execute, staying at most LOOKAHEAD_BATCH_COUNT super-batches ahead of the one being executed.
+        ** Otherwise every super-batch is partitioned before the workers start.
+        **
+        ** With -DCONTINUOUS_BATCH_EXECUTION, workers do not meet at a barrier between super-batches.
+        ** Clusters whose items are not written by the previous super-batch, and which write none of its
+        ** items, are packed into early atomic-batches at the head of the worklist; a worker may take those
+        ** as soon as the previous worklist has been handed out. The remaining, late atomic-batches wait
+        ** until the previous super-batch has completed, so at most two super-batches are in flight.
+        ** Without -DSELECTIVE_CC every atomic-batch is late.
+        **
+        ** With -DDEPENDENCY_GRAPH_EXECUTION, clusters that share contended items are not packed into
+        ** atomic-batches but executed through a DependencyGraph, one transaction at a time and without
+        ** concurrency control. Workers prefer ready transactions of the graph, since it holds the critical
+        ** path of the super-batch, and wait for the graph to drain before the barrier.
+        **
+        ** With -DHOT_KEY_DELEGATION, items accessed by at least HOT_ITEM_THRESHOLD transactions get an
+        ** owner worker. Every cluster touching a hot item goes into the lane of its owner, which executes
+        ** it before anything else, so hot items are accessed serially and skip concurrency control.
+        **
+        ** With -DINCREMENTAL_PARTITIONING, the outcome of clustering every item accessed by more than one
+        ** transaction is carried into the next super-batch. Items that could not be merged and are about as
+        ** hot again keep their concurrency control without another attempt, items that were merged are
+        ** clustered first, and only the items new to the hot set go through the rounds by degree.
+        **
+        ** With -DDYNAMIC_CC, the concurrency control protocol of every super-batch is picked by a
+        ** CCPolicy from its partitioning statistics: by default through fixed contention thresholds,
+        ** with -DADAPTIVE_CC_POLICY from the throughput earlier super-batches reached under each protocol.
+        **
+        ** Clustering is greedy by default: items are merged in increasing order of degree, serially or with
+        ** -DPARALLEL_PARTITIONING through a ParallelPartitioner. -g1 (gPartitionerType) replaces it with the
+        ** min-cut of a MultilevelPartitioner.
+        **
+        ** With -DRECONNAISSANCE, transactions whose parameters do not declare all their items get their
+        ** read-write set from a Reconnaissance run while being partitioned. Those that stray from it are
+        ** deferred; the last worker to reach the barrier executes them alone before opening it.
         */
 		class SharedWorklistScheduler : public BaseScheduler {
 		public:
 			SharedWorklistScheduler(IORedirector *const redirector, ConcurrentExecutor* executor, const size_t &thread_count) 
 			: BaseScheduler(redirector, thread_count), 
 			  executor_(executor),
+			  deferred_txns_(thread_count),
+			  deferred_batch_(NULL),
               raw_batches_(thread_count), 
 			  batches_(), 
-			  waiting_threads_(),
+			  num_batches_(0),
 			  current_batch_idx_(0),
+			  completed_batch_count_(0),
+			  held_batch_idx_(thread_count, -1),
+			  held_graph_node_(thread_count, -1),
 			  lock_(),
-			  done_(false) {}
-			virtual ~SharedWorklistScheduler(){}
+			  waiting_threads_(),
+			  done_(false),
+			  arenas_(),
+			  footprints_(),
+			  partitioner_(NULL) {
+			#if defined(DYNAMIC_CC)
+				cc_policy_ = NULL;
+			#endif
+			}
+			virtual ~SharedWorklistScheduler();
 			virtual void Initialize(const size_t& thread_id);
-            ParamBatch* GetNextBatch(const size_t& thread_id);
+            virtual ParamBatch* GetNextBatch(const size_t& thread_id);
+            virtual void DeferTransaction(const size_t& thread_id, TxnParam* txn);
+            //deferred transactions are only collected at the barrier
+            virtual bool CanDeferTransaction() const {
+            #if defined(CONTINUOUS_BATCH_EXECUTION)
+                return false;
+            #else
+                return true;
+            #endif
+            }
 			void ThreadRun();
+		protected:
+			//returns the deferred transactions if the calling thread has to execute them before the barrier opens
+			ParamBatch* SynchronizeBatchExecution(const size_t& thread_id);
+            //called on every partitioned worklist right before the workers can see it
+            virtual void PrepareWorklist(int batch_idx, SimpleConcurrentWorklist* wl) {}
 		private:
 			SharedWorklistScheduler(const SharedWorklistScheduler&);
 			SharedWorklistScheduler& operator=(const SharedWorklistScheduler&);
-			void SynchronizeBatchExecution(const size_t& thread_id);
             SimpleConcurrentWorklist* DoSimplePartition(int batch_idx);
             SimpleConcurrentWorklist* DoDataBasedPartition(int batch_idx);
+            void DoSerialClustering(std::vector<TxnParam*>& txns, BumpArena* arena, TxnParam** clustered_txns, std::vector<TxnCluster>& clusters, PartitionStatistics& stats);
+            size_t MergeItemClusters(BatchAccessInfo* info, std::unordered_set<TxnParam*>& cluster_heads);
+#if defined(INCREMENTAL_PARTITIONING)
+            void RecordItemHistory(std::unordered_map<int64_t, ItemHistory>& item_history, BatchAccessInfo* info, const size_t& degree, const size_t& cluster_size);
+#endif
+            void RetireWorklist(SimpleConcurrentWorklist* wl);
+            bool ConflictsWith(const TxnCluster& cluster, const ReadWriteSet& footprint);
+            DependencyGraph* ExtractDependencyGraph(const std::vector<TxnParam*>& txns, std::vector<TxnCluster>& clusters, const ConcurrencyControlType& type);
+            void PackAtomicBatches(std::vector<TxnCluster>::iterator begin, std::vector<TxnCluster>::iterator end, const ConcurrencyControlType& type, std::vector<ParamBatch*>& batches);
+            void ExtractHotLanes(std::vector<TxnCluster>& clusters, const ConcurrencyControlType& type, SimpleConcurrentWorklist* wl);
+            //number of leading super-batches whose atomic-batches have all been executed
+            int GetCompletedBatchCount() const;
+#if !defined(MUTE) && defined(PROFILE_BATCH_ANALYTICS)
+            void AnalyzeClusters(int batch_idx, const std::vector<TxnCluster>& clusters, const PartitionStatistics& stats, const ConcurrencyControlType& type);
+            void AnalyzeAtomicBatches(int batch_idx, SimpleConcurrentWorklist* wl);
+#endif
+#if defined(DEPENDENCY_GRAPH_EXECUTION)
+            ParamBatch* GetNextGraphBatch(const size_t& thread_id, DependencyGraph* graph, bool wait_for_done);
+#endif
+#if defined(CONTINUOUS_BATCH_EXECUTION)
+            void AdvanceCompletedBatchCount();
+            void WaitForCompletedBatchCount(const size_t& thread_id, const int& count);
+#endif
+
+            size_t GetPartitionThreadCount() const {
+            #if defined(PARALLEL_PARTITIONING)
+                return gPartitionThreadCount;
+            #else
+                return 1;
+            #endif
+            }
 
 		protected:
             ConcurrentExecutor* executor_;
+			//transactions each worker took off the current super-batch
+			std::vector<std::vector<TxnParam*>> deferred_txns_;
+			ParamBatch* deferred_batch_;
 			//all raw-batches are pre-processed and stored into batches
 			std::vector<std::vector<ParamBatch*>*> raw_batches_;
 
-			std::vector<SimpleConcurrentWorklist*> batches_;
+			BoundedWorklistQueue batches_;
+			size_t num_batches_;
 			std::atomic_int current_batch_idx_;
+			std::atomic_int completed_batch_count_;
+			//super-batch of the atomic-batch each worker is executing, -1 if none
+			std::vector<int> held_batch_idx_;
+			//graph node each worker is executing, -1 if none
+			std::vector<long long> held_graph_node_;
 
 			boost::detail::spinlock lock_;
 			std::vector<size_t> waiting_threads_;
 			volatile bool done_;
+			//read-write sets of a super-batch live in the arenas of its slot, one per partitioning thread
+			std::vector<BumpArena*> arenas_;
+			//items touched by each super-batch in the ring
+			std::vector<ReadWriteSet> footprints_;
+			//NULL if the greedy merge runs serially in DoSerialClustering
+			BasePartitioner* partitioner_;
+#if defined(RECONNAISSANCE)
+			//one per partitioning thread
+			std::vector<Reconnaissance*> reconnaissances_;
+#endif
+#if defined(INCREMENTAL_PARTITIONING)
+			//hot set of the previous super-batch, by data hash
+			std::unordered_map<int64_t, ItemHistory> item_history_;
+#endif
+#if defined(DYNAMIC_CC)
+			CCPolicy* cc_policy_;
+#endif
 
 		};
 
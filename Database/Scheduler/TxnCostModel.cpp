@@ -0,0 +1,8 @@
+#include "TxnCostModel.h"
+
+namespace Cavalia{
+	namespace Database{
+		const double TxnCostModel::kCostDecay = 0.7;
+		TxnCostModel txn_cost_model_;
+	}
+}
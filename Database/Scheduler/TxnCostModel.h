@@ -0,0 +1,125 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_TXN_COST_MODEL_H__
+#define __CAVALIA_DATABASE_TXN_COST_MODEL_H__
+
+#include <atomic>
+#include <cstdint>
+#if defined(PRECISE_TIMER)
+#include <PreciseTimeMeasurer.h>
+#else
+#include <TimeMeasurer.h>
+#endif
+#include "../Meta/MetaTypes.h"
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Class TxnCostModel:
+        ** -------------------
+        ** Online estimate of the execution time of every stored procedure, used by -DCOST_AWARE_PACKING
+        ** to weigh clusters when packing atomic-batches. Workers time each transaction, retries included,
+        ** next to the ExecutionProfiler measurements and add it to per-thread counters. The scheduler
+        ** thread folds what was measured since its last refresh into per-procedure exponentially decaying
+        ** averages before packing a super-batch, so that costs follow shifts of the workload; until a
+        ** procedure has been measured it costs the average of the measured ones.
+        */
+        class TxnCostModel {
+        public:
+            TxnCostModel() {
+                for(size_t i = 0; i < kMaxProcedureNum; i++) {
+                    costs_[i] = 1.0;
+                    is_measured_[i] = false;
+                    last_time_[i] = 0;
+                    last_count_[i] = 0;
+                }
+                for(size_t i = 0; i < kMaxThreadNum; i++) {
+                    for(size_t j = 0; j < kMaxProcedureNum; j++) {
+                        thread_costs_[i].time_[j].store(0, std::memory_order_relaxed);
+                        thread_costs_[i].count_[j].store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            void BeginMeasure(const size_t& thread_id) {
+                thread_costs_[thread_id].timer_.StartTimer();
+            }
+
+            void EndMeasure(const size_t& thread_id, const size_t& txn_type) {
+                ThreadCost& thread_cost = thread_costs_[thread_id];
+                thread_cost.timer_.EndTimer();
+                if(txn_type < kMaxProcedureNum) {
+                    //single writer, the scheduler thread only reads
+                    thread_cost.time_[txn_type].store(thread_cost.time_[txn_type].load(std::memory_order_relaxed) + thread_cost.timer_.GetElapsedNanoSeconds(), std::memory_order_relaxed);
+                    thread_cost.count_[txn_type].store(thread_cost.count_[txn_type].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                }
+            }
+
+            //scheduler thread only
+            void Refresh() {
+                double total_cost = 0.0;
+                size_t measured_count = 0;
+                for(size_t j = 0; j < kMaxProcedureNum; j++) {
+                    uint64_t time = 0, count = 0;
+                    for(size_t i = 0; i < kMaxThreadNum; i++) {
+                        time += thread_costs_[i].time_[j].load(std::memory_order_relaxed);
+                        count += thread_costs_[i].count_[j].load(std::memory_order_relaxed);
+                    }
+                    if(count > last_count_[j]) {
+                        double recent_cost = (double)(time - last_time_[j]) / (count - last_count_[j]);
+                        costs_[j] = is_measured_[j] ? kCostDecay * costs_[j] + (1.0 - kCostDecay) * recent_cost : recent_cost;
+                        is_measured_[j] = true;
+                        last_time_[j] = time;
+                        last_count_[j] = count;
+                    }
+                    if(is_measured_[j]) {
+                        total_cost += costs_[j];
+                        measured_count++;
+                    }
+                }
+                double default_cost = measured_count == 0 ? 1.0 : total_cost / measured_count;
+                for(size_t j = 0; j < kMaxProcedureNum; j++) {
+                    if(!is_measured_[j]) {
+                        costs_[j] = default_cost;
+                    }
+                }
+            }
+
+            double GetCost(const size_t& txn_type) const {
+                return txn_type < kMaxProcedureNum ? costs_[txn_type] : 1.0;
+            }
+
+        private:
+            TxnCostModel(const TxnCostModel&);
+            TxnCostModel& operator=(const TxnCostModel&);
+
+        private:
+#ifdef __linux__
+            struct __attribute__((aligned(64))) ThreadCost {
+#else
+            struct ThreadCost {
+#endif
+#if defined(PRECISE_TIMER)
+                PreciseTimeMeasurer timer_;
+#else
+                TimeMeasurer timer_;
+#endif
+                std::atomic<uint64_t> time_[kMaxProcedureNum];
+                std::atomic<uint64_t> count_[kMaxProcedureNum];
+            };
+
+            //weight of the previous estimate when folding in the transactions measured since the last refresh
+            static const double kCostDecay;
+
+            ThreadCost thread_costs_[kMaxThreadNum];
+            double costs_[kMaxProcedureNum];
+            bool is_measured_[kMaxProcedureNum];
+            //counter totals at the last refresh, scheduler thread only
+            uint64_t last_time_[kMaxProcedureNum];
+            uint64_t last_count_[kMaxProcedureNum];
+        };
+
+        extern TxnCostModel txn_cost_model_;
+	}
+}
+
+#endif
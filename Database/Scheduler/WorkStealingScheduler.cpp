@@ -0,0 +1,137 @@
+#include "WorkStealingScheduler.h"
+#include <algorithm>
+#include "../Executor/ConcurrentExecutor.h"
+
+using namespace Cavalia;
+using namespace Cavalia::Database;
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    for(auto iter = deques_.begin(); iter != deques_.end(); iter++) {
+        delete *iter;
+    }
+    deques_.clear();
+}
+
+//the slot of batch_idx was retired before it got partitioned, so nobody reads its deques
+void WorkStealingScheduler::PrepareWorklist(int batch_idx, SimpleConcurrentWorklist* wl) {
+    if(deques_.empty()) {
+        for(size_t i = 0; i < batches_.Capacity() * thread_count_; i++) {
+            deques_.push_back(new AtomicBatchDeque());
+        }
+        #if defined(AFFINITY_PLACEMENT)
+            for(size_t i = 0; i < thread_count_; i++) {
+                worker_nodes_.push_back(GetNumaNodeId(executor_->GetCoreId(i)));
+            }
+        #endif
+        //starting at the next worker, the workers of the same node first
+        steal_orders_.resize(thread_count_);
+        for(size_t i = 0; i < thread_count_; i++) {
+            for(size_t j = 1; j < thread_count_; j++) {
+                steal_orders_[i].push_back((i + j) % thread_count_);
+            }
+            #if defined(AFFINITY_PLACEMENT)
+                std::stable_partition(steal_orders_[i].begin(), steal_orders_[i].end(), [&](const size_t& victim) {
+                    return worker_nodes_[victim] == worker_nodes_[i];
+                });
+            #endif
+        }
+    }
+    AtomicBatchDeque** deques = GetDeques(batch_idx);
+    for(size_t i = 0; i < thread_count_; i++) {
+        deques[i]->Clear();
+    }
+#if defined(AFFINITY_PLACEMENT)
+    const ReadWriteSet* previous_footprint = NULL;
+    if(batch_idx > 0) {
+        previous_footprint = &footprints_[(batch_idx - 1) % batches_.Capacity()];
+    }
+    size_t total_load = 0;
+    for(size_t i = 0; i < wl->queue_.size(); i++) {
+        total_load += wl->queue_[i]->size();
+    }
+    size_t max_load = (size_t)(std::ceil(total_load * 1.0 / thread_count_) * AFFINITY_LOAD_SLACK);
+    std::vector<size_t> loads(thread_count_, 0);
+    for(size_t i = 0; i < wl->queue_.size(); i++) {
+        deques[PlaceAtomicBatch(wl->queue_[i], previous_footprint, max_load, loads)]->Add(wl->queue_[i]);
+    }
+#else
+    for(size_t i = 0; i < wl->queue_.size(); i++) {
+        deques[i % thread_count_]->Add(wl->queue_[i]);
+    }
+#endif
+}
+
+#if defined(AFFINITY_PLACEMENT)
+//the previous super-batch may still be executing, so its items carry the worker they were placed on
+//rather than the one that executed them. Stolen atomic-batches are rare enough not to matter.
+size_t WorkStealingScheduler::PlaceAtomicBatch(ParamBatch* batch, const ReadWriteSet* previous_footprint, const size_t& max_load, std::vector<size_t>& loads) {
+    std::vector<size_t> votes(thread_count_, 0);
+    if(previous_footprint != NULL) {
+        for(size_t i = 0; i < batch->size(); i++) {
+            ReadWriteSet& rw_set = batch->get(i)->GetReadWriteSet();
+            for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+                BatchAccessInfo* previous_info = previous_footprint->Get(iter->hash_);
+                if(previous_info != NULL && previous_info->owner_thread_ >= 0) {
+                    votes[previous_info->owner_thread_]++;
+                }
+            }
+        }
+    }
+    size_t preferred = std::max_element(votes.begin(), votes.end()) - votes.begin();
+    size_t worker = preferred;
+    if(votes[preferred] == 0 || loads[preferred] + batch->size() > max_load) {
+        //least loaded worker, looking at the node of the preferred worker first
+        long long best_local = -1;
+        size_t best = 0;
+        for(size_t i = 0; i < thread_count_; i++) {
+            if(loads[i] < loads[best]) {
+                best = i;
+            }
+            if(votes[preferred] > 0 && worker_nodes_[i] == worker_nodes_[preferred] && loads[i] + batch->size() <= max_load
+                && (best_local < 0 || loads[i] < loads[best_local])) {
+                best_local = i;
+            }
+        }
+        worker = best_local >= 0 ? (size_t)best_local : best;
+    }
+    loads[worker] += batch->size();
+    for(size_t i = 0; i < batch->size(); i++) {
+        ReadWriteSet& rw_set = batch->get(i)->GetReadWriteSet();
+        for(auto iter = rw_set.begin(); iter != rw_set.end(); iter++) {
+            iter->info_->owner_thread_ = (int)worker;
+        }
+    }
+    return worker;
+}
+#endif
+
+ParamBatch* WorkStealingScheduler::GetNextBatch(const size_t& thread_id) {
+    int current_batch_idx = current_batch_idx_.load();
+    assert(current_batch_idx >= 0);
+    if((size_t)current_batch_idx < num_batches_) {
+        if(batches_.Get(current_batch_idx) == NULL) {
+            //partitioner has not caught up with the workers yet
+            BEGIN_PARTITIONING_STALL_TIME_MEASURE(thread_id);
+            while(batches_.Get(current_batch_idx) == NULL);
+            END_PARTITIONING_STALL_TIME_MEASURE(thread_id);
+        }
+        AtomicBatchDeque** deques = GetDeques(current_batch_idx);
+        ParamBatch* batch = deques[thread_id]->Pop();
+        //own deque is empty : steal from the others
+        std::vector<size_t>& steal_order = steal_orders_[thread_id];
+        for(size_t i = 0; batch == NULL && i < steal_order.size(); i++) {
+            batch = deques[steal_order[i]]->Steal();
+        }
+        if(batch != NULL) {
+            return batch;
+        } else {
+            ParamBatch* deferred_batch = SynchronizeBatchExecution(thread_id);
+            if(deferred_batch != NULL) {
+                return deferred_batch;
+            }
+            return GetNextBatch(thread_id);
+        }
+    } else {
+        return NULL;
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_WORK_STEALING_SCHEDULER_H__
+#define __CAVALIA_DATABASE_WORK_STEALING_SCHEDULER_H__
+
+#include "SharedWorklistScheduler.h"
+#include <vector>
+#include <atomic>
+
+#if defined(WORK_STEALING_SCHEDULER) && defined(CONTINUOUS_BATCH_EXECUTION)
+#error "WORK_STEALING_SCHEDULER synchronizes at super-batch boundaries and cannot be combined with CONTINUOUS_BATCH_EXECUTION"
+#endif
+#if defined(AFFINITY_PLACEMENT) && !(defined(WORK_STEALING_SCHEDULER) && defined(SELECTIVE_CC))
+#error "AFFINITY_PLACEMENT places atomic-batches into the deques of WORK_STEALING_SCHEDULER and needs SELECTIVE_CC"
+#endif
+
+//a worker is given at most this many times its fair share of transactions by affinity
+#define AFFINITY_LOAD_SLACK 1.25
+
+namespace Cavalia{
+	namespace Database{
+        /*
+        ** Chase-Lev deque of atomic-batches. The scheduler thread fills it before the super-batch is
+        ** published, so the array never grows while workers use it: the owner pops from the bottom and
+        ** the other workers steal from the top.
+        */
+        class AtomicBatchDeque {
+        public:
+            AtomicBatchDeque() : top_(0), bottom_(0), items_() {}
+
+            //only called while no worker can see the deque
+            void Clear() {
+                items_.clear();
+                top_.store(0, std::memory_order_relaxed);
+                bottom_.store(0, std::memory_order_relaxed);
+            }
+
+            void Add(ParamBatch* batch) {
+                items_.push_back(batch);
+                bottom_.store(items_.size(), std::memory_order_relaxed);
+            }
+
+            //owner only
+            ParamBatch* Pop() {
+                int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+                bottom_.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = top_.load(std::memory_order_relaxed);
+                if(top > bottom) {
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    return NULL;
+                }
+                ParamBatch* batch = items_[bottom];
+                if(top == bottom) {
+                    //last one, race against the thieves for it
+                    if(!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        batch = NULL;
+                    }
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+                }
+                return batch;
+            }
+
+            //returns NULL only if the deque is empty
+            ParamBatch* Steal() {
+                while(true) {
+                    int64_t top = top_.load(std::memory_order_acquire);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    int64_t bottom = bottom_.load(std::memory_order_acquire);
+                    if(top >= bottom) {
+                        return NULL;
+                    }
+                    ParamBatch* batch = items_[top];
+                    if(top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        return batch;
+                    }
+                }
+            }
+
+        private:
+            AtomicBatchDeque(const AtomicBatchDeque&);
+            AtomicBatchDeque& operator=(const AtomicBatchDeque&);
+
+        private:
+            //thieves and the owner write different ends, keep them on different cache lines
+            std::atomic<int64_t> top_;
+            char padding0_[64];
+            std::atomic<int64_t> bottom_;
+            std::vector<ParamBatch*> items_;
+            char padding1_[64];
+        };
+
+        /*
+        ** Class WorkStealingScheduler:
+        ** ----------------------------
+        ** Partitions super-batches like SharedWorklistScheduler, but instead of handing atomic-batches
+        ** out through the shared counter of the worklist, deals them round-robin into one deque per
+        ** worker. A worker executes from its own deque and steals from the others once it runs dry;
+        ** when every deque is empty it waits at the super-batch barrier. Enabled by
+        ** -DWORK_STEALING_SCHEDULER.
+        **
+        ** With -DAFFINITY_PLACEMENT, an atomic-batch goes to the worker that was given most of its items
+        ** in the previous super-batch, so the records and their TableRecord headers are likely still in
+        ** that core's cache. A worker that would get more than AFFINITY_LOAD_SLACK times its share passes
+        ** the atomic-batch to the least loaded worker of its NUMA node, or of any node if they are all
+        ** full. Idle workers steal from their own NUMA node before crossing sockets.
+        */
+		class WorkStealingScheduler : public SharedWorklistScheduler {
+		public:
+			WorkStealingScheduler(IORedirector *const redirector, ConcurrentExecutor* executor, const size_t &thread_count)
+			: SharedWorklistScheduler(redirector, executor, thread_count), deques_(), steal_orders_() {}
+			virtual ~WorkStealingScheduler();
+            virtual ParamBatch* GetNextBatch(const size_t& thread_id);
+		protected:
+            virtual void PrepareWorklist(int batch_idx, SimpleConcurrentWorklist* wl);
+		private:
+			WorkStealingScheduler(const WorkStealingScheduler&);
+			WorkStealingScheduler& operator=(const WorkStealingScheduler&);
+
+            //deques of the worklist slot of batch_idx, one per worker
+            AtomicBatchDeque** GetDeques(int batch_idx) {
+                return &deques_[(batch_idx % batches_.Capacity()) * thread_count_];
+            }
+#if defined(AFFINITY_PLACEMENT)
+            //worker whose deque batch goes into
+            size_t PlaceAtomicBatch(ParamBatch* batch, const ReadWriteSet* previous_footprint, const size_t& max_load, std::vector<size_t>& loads);
+#endif
+
+		private:
+            std::vector<AtomicBatchDeque*> deques_;
+            //workers each worker steals from, in the order it tries them
+            std::vector<std::vector<size_t>> steal_orders_;
+#if defined(AFFINITY_PLACEMENT)
+            std::vector<size_t> worker_nodes_;
+#endif
+		};
+	}
+}
+
+#endif
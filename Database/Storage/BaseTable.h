@@ -31,6 +31,10 @@ namespace Cavalia{
 
 			///////////////////NEW API//////////////////
 			virtual void SelectKeyRecord(const std::string &key, TableRecord *&record) const = 0;
+			// tables without a fixed-width primary index look the key up as a string.
+			virtual void SelectKeyRecord(const FixedKey &key, TableRecord *&record) const {
+				SelectKeyRecord(key.ToString(), record);
+			}
 			virtual void SelectKeyRecord(const size_t &part_id, const std::string &key, TableRecord *&record) const = 0;
 			virtual void SelectRecord(const size_t &idx_id, const std::string &key, TableRecord *&record) const = 0;
 			virtual void SelectRecord(const size_t &part_id, const size_t &idx_id, const std::string &key, TableRecord *&record) const = 0;
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_FIXED_KEY_H__
+#define __CAVALIA_DATABASE_FIXED_KEY_H__
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+namespace Cavalia{
+	namespace Database{
+		const size_t kMaxFixedKeySize = 16;
+
+		// primary key of at most kMaxFixedKeySize bytes, held inline. the bytes are laid out exactly like
+		// the std::string key built from the same columns, so both reach the same record.
+		struct FixedKey{
+			FixedKey() : size_(0){
+				words_[0] = 0;
+				words_[1] = 0;
+			}
+
+			// single-column key, e.g. FixedKey(custid) for an int64_t column.
+			template<typename T>
+			explicit FixedKey(const T &value) : size_(0){
+				words_[0] = 0;
+				words_[1] = 0;
+				Append(value);
+			}
+
+			FixedKey(const char *data, const size_t &size) : size_(size){
+				assert(size <= kMaxFixedKeySize);
+				words_[0] = 0;
+				words_[1] = 0;
+				memcpy(words_, data, size);
+			}
+
+			// packs the next column of a composite key.
+			template<typename T>
+			FixedKey& Append(const T &value){
+				static_assert(std::is_arithmetic<T>::value, "a fixed key is packed from arithmetic columns");
+				assert(size_ + sizeof(T) <= kMaxFixedKeySize);
+				memcpy((char*)words_ + size_, &value, sizeof(T));
+				size_ += sizeof(T);
+				return *this;
+			}
+
+			const char* data() const{
+				return (const char*)words_;
+			}
+
+			size_t size() const{
+				return size_;
+			}
+
+			std::string ToString() const{
+				return std::string(data(), size_);
+			}
+
+			bool operator==(const FixedKey &other) const{
+				return words_[0] == other.words_[0] && words_[1] == other.words_[1] && size_ == other.size_;
+			}
+
+			bool operator!=(const FixedKey &other) const{
+				return !(*this == other);
+			}
+
+			size_t Hash() const{
+				uint64_t hash = (words_[0] ^ size_) * 0x9E3779B97F4A7C15ULL;
+				hash ^= words_[1] * 0xC2B2AE3D27D4EB4FULL;
+				return (size_t)(hash ^ (hash >> 29));
+			}
+
+			uint64_t words_[2];
+			size_t size_;
+		};
+
+		struct FixedKeyHasher{
+			size_t operator()(const FixedKey &key) const{
+				return key.Hash();
+			}
+		};
+	}
+}
+
+#endif
@@ -4,13 +4,19 @@
 
 #include <CharArray.h>
 #include "RecordSchema.h"
+#include "FixedKey.h"
 
 namespace Cavalia{
 	namespace Database{
 		class SchemaRecord{
 		public:
+#if defined(DIRTY_COLUMNS)
+			SchemaRecord() : schema_ptr_(NULL), is_visible_(true), data_ptr_(NULL), dirty_columns_(0) {}
+			SchemaRecord(const RecordSchema * const schema_ptr, char *data_ptr) : schema_ptr_(schema_ptr), is_visible_(true), data_ptr_(data_ptr), dirty_columns_(0) {}
+#else
 			SchemaRecord() : schema_ptr_(NULL), is_visible_(true), data_ptr_(NULL) {}
 			SchemaRecord(const RecordSchema * const schema_ptr, char *data_ptr) : schema_ptr_(schema_ptr), is_visible_(true), data_ptr_(data_ptr) {}
+#endif
 			~SchemaRecord(){}
 
 			size_t GetTableId() const{
@@ -25,6 +31,33 @@ namespace Cavalia{
 				memcpy(data_ptr_, src_record->data_ptr_, schema_ptr_->GetSchemaSize());
 			}
 
+			// installs src_record, a local copy of this record, at commit. with -DDIRTY_COLUMNS only the columns
+			// set on the copy are written back, adjacent ones with a single memcpy.
+			void InstallFrom(const SchemaRecord *src_record){
+#if defined(DIRTY_COLUMNS)
+				uint64_t dirty_columns = src_record->dirty_columns_;
+				while (dirty_columns != 0){
+					size_t first_column = __builtin_ctzll(dirty_columns);
+					// skip to the end of the run of dirty columns. the run may reach the last bit, where
+					// __builtin_ctzll of the inverted mask is undefined.
+					uint64_t clean_columns = ~(dirty_columns >> first_column);
+					size_t end_column = clean_columns == 0 ? kMaxDirtyColumnNum : first_column + __builtin_ctzll(clean_columns);
+					if (end_column >= kMaxDirtyColumnNum){
+						dirty_columns = 0;
+						end_column = schema_ptr_->GetColumnCount();
+					}
+					else{
+						dirty_columns &= ~(((1ULL << end_column) - 1) >> first_column << first_column);
+					}
+					size_t begin_offset = schema_ptr_->GetColumnOffset(first_column);
+					size_t end_offset = schema_ptr_->GetColumnOffset(end_column - 1) + schema_ptr_->GetColumnSize(end_column - 1);
+					memcpy(data_ptr_ + begin_offset, src_record->data_ptr_ + begin_offset, end_offset - begin_offset);
+				}
+#else
+				CopyFrom(src_record);
+#endif
+			}
+
 			void SwapData(SchemaRecord *src_record){
 				char *tmp_ptr = data_ptr_;
 				data_ptr_ = src_record->data_ptr_;
@@ -33,29 +66,34 @@ namespace Cavalia{
 
 			// set column. type can be any type.
 			void SetColumn(const size_t &column_id, const char *data){
+				MarkDirty(column_id);
 				memcpy(data_ptr_ + schema_ptr_->GetColumnOffset(column_id), data, schema_ptr_->GetColumnSize(column_id));
 			}
 
 			// rename.
 			void UpdateColumn(const size_t &column_id, const char*data){
+				MarkDirty(column_id);
 				memcpy(data_ptr_ + schema_ptr_->GetColumnOffset(column_id), data, schema_ptr_->GetColumnSize(column_id));
 			}
 
 			// set column. type must be varchar.
 			void SetColumn(const size_t &column_id, const CharArray &data){
 				assert(schema_ptr_->GetColumnType(column_id) == ValueType::VARCHAR && schema_ptr_->GetColumnSize(column_id) >= data.size_);
+				MarkDirty(column_id);
 				memcpy(data_ptr_ + schema_ptr_->GetColumnOffset(column_id), data.char_ptr_, data.size_);
 			}
 
 			// set column. type must be varchar.
 			void SetColumn(const size_t &column_id, const char *data_str, const size_t &data_size){
 				assert(schema_ptr_->GetColumnType(column_id) == ValueType::VARCHAR && schema_ptr_->GetColumnSize(column_id) >= data_size);
+				MarkDirty(column_id);
 				memcpy(data_ptr_ + schema_ptr_->GetColumnOffset(column_id), data_str, data_size);
 			}
 
 			// set column. type must be varchar.
 			void SetColumn(const size_t &column_id, const std::string &data){
 				assert(schema_ptr_->GetColumnType(column_id) == ValueType::VARCHAR && schema_ptr_->GetColumnSize(column_id) >= data.size());
+				MarkDirty(column_id);
 				memcpy(data_ptr_ + schema_ptr_->GetColumnOffset(column_id), data.c_str(), data.size());
 			}
 
@@ -115,6 +153,17 @@ namespace Cavalia{
 				return ret_key;
 			}
 
+			// only for schemas whose primary key is at most kMaxFixedKeySize bytes.
+			FixedKey GetPrimaryFixedKey() const {
+				FixedKey key;
+				assert(schema_ptr_->GetPrimaryKeyLength() != 0 && schema_ptr_->GetPrimaryKeyLength() <= kMaxFixedKeySize);
+				for (size_t i = 0; i < schema_ptr_->GetPrimaryColumnCount(); ++i){
+					memcpy((char*)key.words_ + key.size_, GetColumn(schema_ptr_->GetPrimaryColumnId(i)), schema_ptr_->GetPrimaryColumnSize(i));
+					key.size_ += schema_ptr_->GetPrimaryColumnSize(i);
+				}
+				return key;
+			}
+
 			std::string GetSecondaryKey(const size_t &index) const {
 				size_t curr_offset = 0;
 				size_t key_length = schema_ptr_->GetSecondaryKeyLength(index);
@@ -144,10 +193,22 @@ namespace Cavalia{
 			SchemaRecord(const SchemaRecord&);
 			SchemaRecord& operator=(const SchemaRecord&);
 
+			void MarkDirty(const size_t &column_id){
+#if defined(DIRTY_COLUMNS)
+				// columns past the last bit share it, installing everything from there on.
+				dirty_columns_ |= 1ULL << (column_id < kMaxDirtyColumnNum ? column_id : kMaxDirtyColumnNum - 1);
+#endif
+			}
+
 		public:
 			char *data_ptr_;
 			const RecordSchema *schema_ptr_;
 			bool is_visible_;
+#if defined(DIRTY_COLUMNS)
+			static const size_t kMaxDirtyColumnNum = 64;
+			// columns set since the record was created.
+			uint64_t dirty_columns_;
+#endif
 		};
 	}
 }
@@ -137,8 +137,9 @@ namespace Cavalia {
 					part_id = GetPartitionId(record->record_);
 				}
 				primary_index_[part_id]->DeleteRecord(primary_key);
+				SchemaRecord *record_ptr = record->record_;
 				for (size_t i = 0; i < secondary_count_; ++i) {
-					secondary_indexes_[part_id][i]->DeleteRecord(primary_key);
+					secondary_indexes_[part_id][i]->DeleteRecord(record_ptr->GetSecondaryKey(i), record);
 				}
 			}
 			///////////////////NEW API//////////////////
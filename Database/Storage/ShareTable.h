@@ -5,22 +5,35 @@
 #include "BaseTable.h"
 #include "../Index/StdUnorderedIndex.h"
 #include "../Index/StdUnorderedIndexMT.h"
+#include "../Index/StdFixedKeyIndex.h"
+#include "../Index/StdFixedKeyIndexMT.h"
 #include "../Index/StdOrderedIndex.h"
 #include "../Index/StdOrderedIndexMT.h"
 #if defined(CUCKOO_INDEX)
 #include "../Index/CuckooIndex.h"
+#include "../Index/CuckooFixedKeyIndex.h"
 #endif
 
 namespace Cavalia{
 	namespace Database{
 		class ShareTable : public BaseTable {
 		public:
-			ShareTable(const RecordSchema * const schema_ptr, bool is_thread_safe) : BaseTable(schema_ptr){
+			ShareTable(const RecordSchema * const schema_ptr, bool is_thread_safe) : BaseTable(schema_ptr), is_fixed_key_(schema_ptr->GetPrimaryKeyLength() != 0 && schema_ptr->GetPrimaryKeyLength() <= kMaxFixedKeySize){
 				if (is_thread_safe == true){
 #if defined(CUCKOO_INDEX)
-					primary_index_ = new CuckooIndex();
+					if (is_fixed_key_ == true){
+						primary_index_ = new CuckooFixedKeyIndex();
+					}
+					else{
+						primary_index_ = new CuckooIndex();
+					}
 #else
-					primary_index_ = new StdUnorderedIndexMT();
+					if (is_fixed_key_ == true){
+						primary_index_ = new StdFixedKeyIndexMT();
+					}
+					else{
+						primary_index_ = new StdUnorderedIndexMT();
+					}
 #endif
 					secondary_indexes_ = new BaseOrderedIndex*[secondary_count_];
 					for (size_t i = 0; i < secondary_count_; ++i){
@@ -28,7 +41,12 @@ namespace Cavalia{
 					}
 				}
 				else{
-					primary_index_ = new StdUnorderedIndex();
+					if (is_fixed_key_ == true){
+						primary_index_ = new StdFixedKeyIndex();
+					}
+					else{
+						primary_index_ = new StdUnorderedIndex();
+					}
 					secondary_indexes_ = new BaseOrderedIndex*[secondary_count_];
 					for (size_t i = 0; i < secondary_count_; ++i){
 						secondary_indexes_[i] = new StdOrderedIndex();
@@ -56,7 +74,14 @@ namespace Cavalia{
 			///////////////////INSERT//////////////////
 			virtual bool InsertRecord(TableRecord *record){
 				SchemaRecord *record_ptr = record->record_;
-				if (primary_index_->InsertRecord(record_ptr->GetPrimaryKey(), record) == true){
+				bool is_inserted = false;
+				if (is_fixed_key_ == true){
+					is_inserted = primary_index_->InsertRecord(record_ptr->GetPrimaryFixedKey(), record);
+				}
+				else{
+					is_inserted = primary_index_->InsertRecord(record_ptr->GetPrimaryKey(), record);
+				}
+				if (is_inserted == true){
 					// build secondary index here
 					for (size_t i = 0; i < secondary_count_; ++i){
 						secondary_indexes_[i]->InsertRecord(record_ptr->GetSecondaryKey(i), record);
@@ -85,20 +110,24 @@ namespace Cavalia{
 			/////////////////////DELETE//////////////////
 			virtual void DeleteRecord(TableRecord *record){
 				SchemaRecord *record_ptr = record->record_;
-				primary_index_->DeleteRecord(record_ptr->GetPrimaryKey());
+				if (is_fixed_key_ == true){
+					primary_index_->DeleteRecord(record_ptr->GetPrimaryFixedKey());
+				}
+				else{
+					primary_index_->DeleteRecord(record_ptr->GetPrimaryKey());
+				}
 				// update secondary index here
 				for (size_t i = 0; i < secondary_count_; ++i){
-					secondary_indexes_[i]->DeleteRecord(record_ptr->GetSecondaryKey(i));
+					secondary_indexes_[i]->DeleteRecord(record_ptr->GetSecondaryKey(i), record);
 				}
-				// ========================IMPORTANT========================
-				// TODO: deletion should rely on a garbage collector. potential memory leak!
+				// the record is only unlinked. its memory is reclaimed by GarbageCollector once no reader can hold it.
 			}
 
 			virtual void DeleteRecord(const std::string &primary_key, TableRecord *record) {
 				primary_index_->DeleteRecord(primary_key);
 				SchemaRecord *record_ptr = record->record_;
 				for (size_t i = 0; i < secondary_count_; ++i) {
-					secondary_indexes_[i]->DeleteRecord(record_ptr->GetSecondaryKey(i));
+					secondary_indexes_[i]->DeleteRecord(record_ptr->GetSecondaryKey(i), record);
 				}
 			}
 
@@ -107,6 +136,10 @@ namespace Cavalia{
 				record = primary_index_->SearchRecord(primary_key);
 			}
 
+			virtual void SelectKeyRecord(const FixedKey &primary_key, TableRecord *&record) const {
+				record = primary_index_->SearchRecord(primary_key);
+			}
+
 			virtual void SelectKeyRecord(const size_t &part_id, const std::string &primary_key, TableRecord *&record) const {
 				assert(false);
 			}
@@ -179,6 +212,8 @@ namespace Cavalia{
 			ShareTable & operator=(const ShareTable&);
 
 		protected:
+			// whether the primary key fits in a FixedKey, in which case the primary index is keyed by it.
+			const bool is_fixed_key_;
 			BaseUnorderedIndex *primary_index_;
 			BaseOrderedIndex **secondary_indexes_;
 		};
@@ -4,13 +4,23 @@
 
 #include "SchemaRecord.h"
 
+#if defined(MIXED_CC) && defined(DYNAMIC_CC)
+#error "MIXED_CC chooses the protocol per record and cannot be combined with DYNAMIC_CC"
+#endif
+
 #if defined(DYNAMIC_CC)
 #include "../Content/LockWaitContent.h"
 #include "../Content/LockContent.h"
+#elif defined(MIXED_CC)
+#include "../Content/LockWaitContent.h"
+#include "../Content/LockContent.h"
+#include "../Content/TemperatureContent.h"
 #elif defined(LOCK_WAIT)
 #include "../Content/LockWaitContent.h"
-#elif defined(LOCK) || defined(OCC) || defined(SILO) || defined(ST)
+#elif defined(LOCK) || defined(OCC) || defined(ST)
 #include "../Content/LockContent.h"
+#elif defined(SILO)
+#include "../Content/TidContent.h"
 #elif defined(SILOCK) || defined(SIOCC)
 #include "../Content/SiLockContent.h"
 #elif defined(TO)
@@ -42,23 +52,32 @@ namespace Cavalia{
 #endif
 
 #if defined(MVLOCK_WAIT) || defined(MVLOCK) || defined(MVOCC) || defined(MVTO) || defined(SILOCK) || defined(SIOCC)
-			TableRecord(SchemaRecord *record) : record_(record), content_(record->data_ptr_) {}
+			TableRecord(SchemaRecord *record) : record_(record), is_inserted_(false), content_(record->data_ptr_) {}
 #elif defined(TO)
-			TableRecord(SchemaRecord *record) : record_(record), content_(record->data_ptr_, record->schema_ptr_->GetSchemaSize()) {}
+			TableRecord(SchemaRecord *record) : record_(record), is_inserted_(false), content_(record->data_ptr_, record->schema_ptr_->GetSchemaSize()) {}
 #else
-			TableRecord(SchemaRecord *record) : record_(record) {}
+			TableRecord(SchemaRecord *record) : record_(record), is_inserted_(false) {}
 #endif
 			~TableRecord(){}
 			
 			SchemaRecord *record_;
+			// set for records inserted by transactions, whose SchemaRecord and data come from MemAllocator.
+			// populated records are allocated by new.
+			bool is_inserted_;
 
 #if defined(DYNAMIC_CC)
 			LockWaitContent wait_content_; //for 2PL
 			LockContent content_; //for OCC
+#elif defined(MIXED_CC)
+			LockWaitContent wait_content_; //locked early by transactions while the record is hot
+			LockContent content_; //validated by every transaction
+			TemperatureContent temperature_;
 #elif defined(LOCK_WAIT)
 			LockWaitContent wait_content_;
-#elif defined(LOCK) || defined(OCC) || defined(SILO) || defined(ST)
+#elif defined(LOCK) || defined(OCC) || defined(ST)
 			LockContent content_;
+#elif defined(SILO)
+			TidContent content_;
 #elif defined(SILOCK) || defined(SIOCC)
 			SiLockContent content_;
 #elif defined(TO)
@@ -1,3 +1,17 @@
 #include "Epoch.h"
+#include "GlobalTimestamp.h"
+#include "GarbageCollector.h"
 
 volatile uint64_t Cavalia::Database::Epoch::curr_epoch_ = 1;
+
+namespace Cavalia {
+	namespace Database {
+		void Epoch::Start() {
+			while (true) {
+				boost::this_thread::sleep(boost::posix_time::milliseconds(40));
+				++curr_epoch_;
+				GarbageCollector::RefreshSafeEpoch(GlobalTimestamp::thread_count_);
+			}
+		}
+	}
+}
@@ -32,12 +32,8 @@ namespace Cavalia {
 			}
 
 		private:
-			void Start() {
-				while (true) {
-					boost::this_thread::sleep(boost::posix_time::milliseconds(40));
-					++curr_epoch_;
-				}
-			}
+			// advances the epoch every 40ms, and with it the safe epoch of GarbageCollector.
+			void Start();
 
 		private:
 			static volatile uint64_t curr_epoch_;
@@ -0,0 +1,8 @@
+#include "GarbageCollector.h"
+
+namespace Cavalia{
+	namespace Database{
+		GarbageCollector::ThreadState GarbageCollector::thread_states_[kMaxThreadNum];
+		std::atomic<uint64_t> GarbageCollector::safe_epoch_(0);
+	}
+}
@@ -0,0 +1,179 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_GARBAGE_COLLECTOR_H__
+#define __CAVALIA_DATABASE_GARBAGE_COLLECTOR_H__
+
+#include <atomic>
+#include <deque>
+#include <AllocatorHelper.h>
+#include "../Meta/MetaTypes.h"
+#include "../Content/ContentCommon.h"
+#include "../Storage/TableRecord.h"
+#include "Epoch.h"
+
+namespace Cavalia{
+	namespace Database{
+		struct VersionGcStatistics{
+			VersionGcStatistics() : installed_count_(0), retired_count_(0), freed_count_(0), pending_bytes_(0), chain_length_sum_(0), max_chain_length_(0){}
+
+			size_t installed_count_;
+			size_t retired_count_;
+			size_t freed_count_;
+			// bytes of retired versions that are not freed yet.
+			size_t pending_bytes_;
+			// history length of the record after each install.
+			size_t chain_length_sum_;
+			size_t max_chain_length_;
+		};
+
+		/*
+		** Class GarbageCollector:
+		** -----------------------
+		** Epoch-based reclamation of the versions that MvToContent and MvOccContent unlink from their
+		** history once no snapshot at or above the GlobalTimestamp low watermark can see them, and of the
+		** records that committed deletes unlink from their table. A worker retires what it unlinked into
+		** its own lists, tagged with the current Epoch, and passes a quiescent point after every
+		** transaction, where it holds no version or record pointer any more. The Epoch thread advances the
+		** safe epoch to the oldest quiescent point of all workers, and a worker frees what it retired
+		** before that epoch at its next quiescent point.
+		*/
+		class GarbageCollector{
+		public:
+			// versions is a list linked through next_, detached from the history of a record.
+			static void Retire(const size_t &thread_id, MvHistoryEntry *versions, const size_t &record_size){
+				ThreadState &state = thread_states_[thread_id];
+				size_t count = 0;
+				for (MvHistoryEntry *entry = versions; entry != NULL; entry = entry->next_){
+					++count;
+				}
+				RetiredVersions retired;
+				retired.epoch_ = Epoch::GetEpoch();
+				retired.versions_ = versions;
+				retired.bytes_ = count * record_size;
+				state.retired_.push_back(retired);
+				state.statistics_.retired_count_ += count;
+				state.statistics_.pending_bytes_ += retired.bytes_;
+			}
+
+			// record is no longer reachable from any index of its table. populated records hold a SchemaRecord
+			// and data allocated by new, records inserted by transactions hold ones from MemAllocator.
+			static void RetireRecord(const size_t &thread_id, TableRecord *record){
+				RetiredRecord retired;
+				retired.epoch_ = Epoch::GetEpoch();
+				retired.record_ = record;
+				thread_states_[thread_id].retired_records_.push_back(retired);
+			}
+
+			static void RecordInstall(const size_t &thread_id, const size_t &chain_length){
+				VersionGcStatistics &statistics = thread_states_[thread_id].statistics_;
+				++statistics.installed_count_;
+				statistics.chain_length_sum_ += chain_length;
+				if (chain_length > statistics.max_chain_length_){
+					statistics.max_chain_length_ = chain_length;
+				}
+			}
+
+			// the worker holds no version it read from a history, nor any record it found in an index.
+			static void Quiesce(const size_t &thread_id){
+				ThreadState &state = thread_states_[thread_id];
+				state.quiescent_epoch_.store(Epoch::GetEpoch(), std::memory_order_release);
+				uint64_t safe_epoch = safe_epoch_.load(std::memory_order_acquire);
+				while (state.retired_.empty() == false && state.retired_.front().epoch_ < safe_epoch){
+					RetiredVersions &retired = state.retired_.front();
+					MvHistoryEntry *entry = retired.versions_;
+					while (entry != NULL){
+						MvHistoryEntry *tmp_entry = entry;
+						entry = entry->next_;
+						MemAllocator::Free(tmp_entry->data_ptr_);
+						delete tmp_entry;
+						tmp_entry = NULL;
+						++state.statistics_.freed_count_;
+					}
+					state.statistics_.pending_bytes_ -= retired.bytes_;
+					state.retired_.pop_front();
+				}
+				while (state.retired_records_.empty() == false && state.retired_records_.front().epoch_ < safe_epoch){
+					TableRecord *record = state.retired_records_.front().record_;
+					if (record->is_inserted_ == true){
+						MemAllocator::Free(record->record_->data_ptr_);
+						record->record_->data_ptr_ = NULL;
+						record->record_->~SchemaRecord();
+						MemAllocator::Free((char*)(record->record_));
+					}
+					else{
+						delete[] record->record_->data_ptr_;
+						record->record_->data_ptr_ = NULL;
+						delete record->record_;
+					}
+					record->record_ = NULL;
+					delete record;
+					record = NULL;
+					state.retired_records_.pop_front();
+				}
+			}
+
+			// called by Epoch only. a worker quiescent at epoch e has dropped everything retired before e.
+			static void RefreshSafeEpoch(const size_t &thread_count){
+				if (thread_count == 0){
+					return;
+				}
+				uint64_t safe_epoch = thread_states_[0].quiescent_epoch_.load(std::memory_order_acquire);
+				for (size_t i = 1; i < thread_count; ++i){
+					uint64_t epoch = thread_states_[i].quiescent_epoch_.load(std::memory_order_acquire);
+					if (epoch < safe_epoch){
+						safe_epoch = epoch;
+					}
+				}
+				safe_epoch_.store(safe_epoch, std::memory_order_release);
+			}
+
+			// sums the counters of all the workers. they are read without synchronization, good enough for sampling.
+			static VersionGcStatistics GetStatistics(const size_t &thread_count){
+				VersionGcStatistics total;
+				for (size_t i = 0; i < thread_count; ++i){
+					const VersionGcStatistics &statistics = thread_states_[i].statistics_;
+					total.installed_count_ += statistics.installed_count_;
+					total.retired_count_ += statistics.retired_count_;
+					total.freed_count_ += statistics.freed_count_;
+					total.pending_bytes_ += statistics.pending_bytes_;
+					total.chain_length_sum_ += statistics.chain_length_sum_;
+					if (statistics.max_chain_length_ > total.max_chain_length_){
+						total.max_chain_length_ = statistics.max_chain_length_;
+					}
+				}
+				return total;
+			}
+
+		private:
+			struct RetiredVersions{
+				uint64_t epoch_;
+				MvHistoryEntry *versions_;
+				size_t bytes_;
+			};
+
+			struct RetiredRecord{
+				uint64_t epoch_;
+				TableRecord *record_;
+			};
+
+#ifdef __linux__
+			struct __attribute__((aligned(64))) ThreadState{
+#else
+			struct ThreadState{
+#endif
+				ThreadState() : quiescent_epoch_(0){}
+
+				// written by the worker, read by Watermark.
+				std::atomic<uint64_t> quiescent_epoch_;
+				// oldest first, epochs never decrease.
+				std::deque<RetiredVersions> retired_;
+				std::deque<RetiredRecord> retired_records_;
+				VersionGcStatistics statistics_;
+			};
+
+			static ThreadState thread_states_[kMaxThreadNum];
+			static std::atomic<uint64_t> safe_epoch_;
+		};
+	}
+}
+
+#endif
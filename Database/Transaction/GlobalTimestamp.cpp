@@ -4,7 +4,9 @@ namespace Cavalia{
 	namespace Database{
 		std::atomic<uint64_t> GlobalTimestamp::monotone_timestamp_(1);
 
-		std::atomic<uint64_t> *GlobalTimestamp::thread_timestamp_[kMaxThreadNum];
+		GlobalTimestamp::PaddedTimestamp GlobalTimestamp::thread_timestamps_[kMaxThreadNum];
+		GlobalTimestamp::PaddedTimestamp GlobalTimestamp::min_timestamp_;
+		GlobalTimestamp::PaddedTimestamp GlobalTimestamp::max_timestamp_;
 		size_t GlobalTimestamp::thread_count_ = 0;
 	}
 }
@@ -25,39 +25,63 @@ namespace Cavalia{
 			// for multiversion concurrency control, including snapshot isolation. 
 			// the purpose is (1) to collect garbage for version maintenance; (2) generate a timestamp to retrieve consistent snapshot.
 
+			// readers get the watermarks that Watermark last aggregated from the per-thread timestamps, one load each
+			// instead of a scan over all the threads. a stale value is what an earlier call returned, and both
+			// watermarks only grow, so a snapshot or garbage-collection horizon taken from it stays safe.
+
 			// for OCC or 2PL, we can use maximum timestamp to retrieve consistent snapshot.
 			// this is because the timestamp for OCC and 2PL is generated at the commit time, and new committed transactions must have larger timestamp.
 			static uint64_t GetMaxTimestamp(){
-				uint64_t res = *(thread_timestamp_[0]);
-				for (size_t i = 0; i < thread_count_; ++i){
-					if (*(thread_timestamp_[i]) > res){
-						res = *(thread_timestamp_[i]);
-					}
-				}
-				return res;
+				return max_timestamp_.timestamp_.load(std::memory_order_acquire);
 			}
 
 			// for TO, we can use minimum timestamp to retrieve consistent snapshot.
 			// this is because the timestamp for TO is generated at the beginning of a transaction, and "staled" transactions can still commit.
 			static uint64_t GetMinTimestamp(){
-				uint64_t res = *(thread_timestamp_[0]);
-				for (size_t i = 1; i < thread_count_; ++i){
-					if (*(thread_timestamp_[i]) < res){
-						res = *(thread_timestamp_[i]);
-					}
-				}
-				return res;
+				return min_timestamp_.timestamp_.load(std::memory_order_acquire);
 			}
 
 			static void SetThreadTimestamp(const size_t &thread_id, const uint64_t &timestamp){
-				*(thread_timestamp_[thread_id]) = timestamp;
+				thread_timestamps_[thread_id].timestamp_.store(timestamp, std::memory_order_release);
+			}
+
+			// called by Watermark only.
+			static void RefreshWatermarks(){
+				if (thread_count_ == 0){
+					return;
+				}
+				uint64_t min_ts = thread_timestamps_[0].timestamp_.load(std::memory_order_acquire);
+				uint64_t max_ts = min_ts;
+				for (size_t i = 1; i < thread_count_; ++i){
+					uint64_t ts = thread_timestamps_[i].timestamp_.load(std::memory_order_acquire);
+					if (ts < min_ts){
+						min_ts = ts;
+					}
+					if (ts > max_ts){
+						max_ts = ts;
+					}
+				}
+				min_timestamp_.timestamp_.store(min_ts, std::memory_order_release);
+				max_timestamp_.timestamp_.store(max_ts, std::memory_order_release);
 			}
 			///////////////////////
 
+		private:
+			// one cache line per timestamp, so that a thread publishing its progress does not invalidate its neighbours'.
+#ifdef __linux__
+			struct __attribute__((aligned(64))) PaddedTimestamp{
+#else
+			struct PaddedTimestamp{
+#endif
+				std::atomic<uint64_t> timestamp_;
+			};
+
 		public:
 			static std::atomic<uint64_t> monotone_timestamp_;
 
-			static std::atomic<uint64_t> *thread_timestamp_[kMaxThreadNum];
+			static PaddedTimestamp thread_timestamps_[kMaxThreadNum];
+			static PaddedTimestamp min_timestamp_;
+			static PaddedTimestamp max_timestamp_;
 			static size_t thread_count_;
 		};
 	}
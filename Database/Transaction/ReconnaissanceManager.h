@@ -0,0 +1,171 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_RECONNAISSANCE_MANAGER_H__
+#define __CAVALIA_DATABASE_RECONNAISSANCE_MANAGER_H__
+
+#if defined(RECONNAISSANCE)
+#include <vector>
+#include "TransactionManager.h"
+#include "../Scheduler/AccessInfo.h"
+
+namespace Cavalia{
+	namespace Database{
+		/*
+		** Class ReconnaissanceManager:
+		** ----------------------------
+		** Enabled by -DRECONNAISSANCE compiler flag
+		**
+		** Transaction manager for the dry run of a procedure whose parameters do not tell which items it
+		** accesses. Every item the procedure selects is added to the read-write set of the transaction and
+		** to the set of its super-batch. Reads see the global records without any concurrency control,
+		** writes go to scratch copies that are dropped with the run, and nothing is ever committed. The
+		** run may therefore see an inconsistent state; the executor validates every access against the
+		** set and defers the transactions that stray from it.
+		*/
+		class ReconnaissanceManager : public TransactionManager{
+		public:
+			ReconnaissanceManager(BaseStorageManager *const storage_manager) : TransactionManager(storage_manager, NULL), txn_(NULL), batch_rw_set_(NULL){
+				t_records_ = new TableRecords(64);
+			}
+			virtual ~ReconnaissanceManager(){
+				DropScratchRecords();
+				delete t_records_;
+				t_records_ = NULL;
+			}
+
+			void BeginReconnaissance(TxnParam *txn, ReadWriteSet *batch_rw_set){
+				txn_ = txn;
+				batch_rw_set_ = batch_rw_set;
+			}
+
+			void EndReconnaissance(){
+				DropScratchRecords();
+				txn_ = NULL;
+				batch_rw_set_ = NULL;
+			}
+
+			// inserted records never reach an index before their commit, so they cannot conflict.
+			virtual bool InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record){
+				MemAllocator::Free(record->data_ptr_);
+				record->~SchemaRecord();
+				MemAllocator::Free((char*)record);
+				return true;
+			}
+
+			virtual bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectKeyRecord(primary_key, t_record);
+				if (t_record != NULL){
+					record = Reconnoiter(table_id, primary_key, t_record, access_type);
+				}
+				return true;
+			}
+
+			virtual bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const FixedKey &primary_key, SchemaRecord *&record, const AccessType access_type){
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectKeyRecord(primary_key, t_record);
+				if (t_record != NULL){
+					record = Reconnoiter(table_id, primary_key.data(), primary_key.size(), t_record, access_type);
+				}
+				return true;
+			}
+
+			virtual bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectKeyRecord(partition_id, primary_key, t_record);
+				if (t_record != NULL){
+					record = Reconnoiter(table_id, primary_key, t_record, access_type);
+				}
+				return true;
+			}
+
+			virtual bool SelectRecord(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectRecord(idx_id, secondary_key, t_record);
+				if (t_record != NULL){
+					record = Reconnoiter(table_id, t_record->record_->GetPrimaryKey(), t_record, access_type);
+				}
+				return true;
+			}
+
+			virtual bool SelectRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectRecord(partition_id, idx_id, secondary_key, t_record);
+				if (t_record != NULL){
+					record = Reconnoiter(table_id, t_record->record_->GetPrimaryKey(), t_record, access_type);
+				}
+				return true;
+			}
+
+			virtual bool SelectRecords(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type){
+				storage_manager_->tables_[table_id]->SelectRecords(idx_id, secondary_key, t_records_);
+				ReconnoiterAll(table_id, records, access_type);
+				return true;
+			}
+
+			virtual bool SelectRecords(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type){
+				storage_manager_->tables_[table_id]->SelectRecords(partition_id, idx_id, secondary_key, t_records_);
+				ReconnoiterAll(table_id, records, access_type);
+				return true;
+			}
+
+			virtual bool CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str){
+				DropScratchRecords();
+				return true;
+			}
+
+			virtual void AbortTransaction(TxnContext *context){
+				DropScratchRecords();
+			}
+
+		private:
+			ReconnaissanceManager(const ReconnaissanceManager &);
+			ReconnaissanceManager& operator=(const ReconnaissanceManager &);
+
+			SchemaRecord* Reconnoiter(const size_t &table_id, const std::string &primary_key, TableRecord *t_record, const AccessType access_type){
+				return Reconnoiter(table_id, primary_key.data(), primary_key.size(), t_record, access_type);
+			}
+
+			SchemaRecord* Reconnoiter(const size_t &table_id, const char *primary_key, const size_t &key_size, TableRecord *t_record, const AccessType access_type){
+				bool is_write = (access_type != READ_ONLY && access_type != NO_CC_READ_ONLY);
+				txn_->GetReadWriteSet().AddAccess(*batch_rw_set_, txn_, GetRecordHash(table_id, primary_key, key_size), is_write);
+				if (is_write == false){
+					return t_record->record_;
+				}
+				// the procedure may update what it selected for writing, which must not reach the table.
+				const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
+				char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
+				SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
+				new(local_record)SchemaRecord(schema_ptr, local_data);
+				local_record->CopyFrom(t_record->record_);
+				scratch_records_.push_back(local_record);
+				return local_record;
+			}
+
+			void ReconnoiterAll(const size_t &table_id, SchemaRecords *records, const AccessType access_type){
+				for (size_t i = 0; i < t_records_->curr_size_; ++i){
+					TableRecord *t_record = t_records_->records_[i];
+					records->records_[i] = Reconnoiter(table_id, t_record->record_->GetPrimaryKey(), t_record, access_type);
+				}
+				t_records_->Clear();
+			}
+
+			void DropScratchRecords(){
+				for (size_t i = 0; i < scratch_records_.size(); ++i){
+					SchemaRecord *local_record = scratch_records_[i];
+					MemAllocator::Free(local_record->data_ptr_);
+					local_record->~SchemaRecord();
+					MemAllocator::Free((char*)local_record);
+				}
+				scratch_records_.clear();
+			}
+
+		private:
+			TxnParam *txn_;
+			ReadWriteSet *batch_rw_set_;
+			std::vector<SchemaRecord*> scratch_records_;
+		};
+	}
+}
+#endif
+
+#endif
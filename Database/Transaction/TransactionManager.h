@@ -18,6 +18,14 @@
 #include "GlobalTimestamp.h"
 #include "BatchTimestamp.h"
 #include "Epoch.h"
+#include "Watermark.h"
+#include "GarbageCollector.h"
+#if defined(RECONNAISSANCE)
+#include "../Scheduler/AccessInfo.h"
+#endif
+#if defined(TXN_ARENA)
+#include <BumpArena.h>
+#endif
 
 //macro programming
 #define CC_INSERT_FUNCTION(NAME) InsertRecord_ ## NAME
@@ -45,6 +53,16 @@ CC_ABORT_FUNCTION_HEADER(NAME); \
 #include <RtmLock.h>
 #endif
 
+#if defined(RECONNAISSANCE)
+#if !(defined(OCC) || defined(SILO) || defined(LOCK) || defined(LOCK_WAIT) || defined(DYNAMIC_CC) || defined(MIXED_CC))
+#error "RECONNAISSANCE needs a protocol that can abort a transaction before its commit"
+#endif
+// the ReconnaissanceManager replaces the accessors with a dry run.
+#define RECONNAISSANCE_VIRTUAL virtual
+#else
+#define RECONNAISSANCE_VIRTUAL
+#endif
+
 namespace Cavalia{
 	namespace Database{
 		class TransactionManager{
@@ -52,14 +70,16 @@ namespace Cavalia{
 			// for executors
 			TransactionManager(BaseStorageManager *const storage_manager, BaseLogger *const logger, const size_t &thread_id, const size_t &thread_count) : storage_manager_(storage_manager), logger_(logger), thread_id_(thread_id), thread_count_(thread_count){
 				table_count_ = storage_manager->table_count_;
+#if defined(RECONNAISSANCE)
+				is_reconnaissance_stale_ = false;
+#endif
 				is_first_access_ = true;
 				local_epoch_ = 0;
 				local_ts_ = 0;
 				t_records_ = new TableRecords(64);
 				
 				// for multi-version concurrency-control schemes.
-				this->progress_ts_ = 0;
-				GlobalTimestamp::thread_timestamp_[thread_id_] = &(this->progress_ts_);
+				GlobalTimestamp::SetThreadTimestamp(thread_id_, 0);
 			}
 
 			// for replayer.
@@ -74,18 +94,23 @@ namespace Cavalia{
 			}
 #endif
 
-			bool InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record);
+			RECONNAISSANCE_VIRTUAL bool InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record);
 			bool InsertRecord(TxnContext *context, const size_t &table_id, SchemaRecord *record){
 				return InsertRecord(context, table_id, record->GetPrimaryKey(), record);
 			}
 
 			// shared
-			bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
+			RECONNAISSANCE_VIRTUAL bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				TableRecord *t_record = NULL;
 				storage_manager_->tables_[table_id]->SelectKeyRecord(primary_key, t_record);
 				END_INDEX_TIME_MEASURE(thread_id_);
 				if (t_record != NULL) {
+#if defined(RECONNAISSANCE)
+					if (ValidateReconnaissance(context, table_id, primary_key) == false) {
+						return false;
+					}
+#endif
 					BEGIN_PHASE_MEASURE(thread_id_, SELECT_PHASE);
 					bool rt = SelectRecordCC(context, table_id, t_record, record, access_type);
 					END_PHASE_MEASURE(thread_id_, SELECT_PHASE);
@@ -97,13 +122,39 @@ namespace Cavalia{
 				}
 			}
 
+			// shared, primary key packed into a FixedKey.
+			RECONNAISSANCE_VIRTUAL bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const FixedKey &primary_key, SchemaRecord *&record, const AccessType access_type){
+				BEGIN_INDEX_TIME_MEASURE(thread_id_);
+				TableRecord *t_record = NULL;
+				storage_manager_->tables_[table_id]->SelectKeyRecord(primary_key, t_record);
+				END_INDEX_TIME_MEASURE(thread_id_);
+				if (t_record != NULL) {
+#if defined(RECONNAISSANCE)
+					if (ValidateReconnaissance(context, table_id, primary_key.data(), primary_key.size()) == false) {
+						return false;
+					}
+#endif
+					BEGIN_PHASE_MEASURE(thread_id_, SELECT_PHASE);
+					bool rt = SelectRecordCC(context, table_id, t_record, record, access_type);
+					END_PHASE_MEASURE(thread_id_, SELECT_PHASE);
+					return rt;
+				} else {
+					return true;
+				}
+			}
+
 			// partition
-			bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
+			RECONNAISSANCE_VIRTUAL bool SelectKeyRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const std::string &primary_key, SchemaRecord *&record, const AccessType access_type){
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				TableRecord *t_record = NULL;
 				storage_manager_->tables_[table_id]->SelectKeyRecord(partition_id, primary_key, t_record);
 				END_INDEX_TIME_MEASURE(thread_id_);
 				if (t_record != NULL){
+#if defined(RECONNAISSANCE)
+					if (ValidateReconnaissance(context, table_id, primary_key) == false) {
+						return false;
+					}
+#endif
 					BEGIN_PHASE_MEASURE(thread_id_, SELECT_PHASE);
 					bool rt = SelectRecordCC(context, table_id, t_record, record, access_type);
 					END_PHASE_MEASURE(thread_id_, SELECT_PHASE);
@@ -117,12 +168,17 @@ namespace Cavalia{
 			}
 
 			// shared
-			bool SelectRecord(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
+			RECONNAISSANCE_VIRTUAL bool SelectRecord(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				TableRecord *t_record = NULL;
 				storage_manager_->tables_[table_id]->SelectRecord(idx_id, secondary_key, t_record);
 				END_INDEX_TIME_MEASURE(thread_id_);
 				if (t_record != NULL){
+#if defined(RECONNAISSANCE)
+					if (context->recon_rw_set_ != NULL && ValidateReconnaissance(context, table_id, t_record->record_->GetPrimaryKey()) == false) {
+						return false;
+					}
+#endif
 					BEGIN_PHASE_MEASURE(thread_id_, SELECT_PHASE);
 					bool rt = SelectRecordCC(context, table_id, t_record, record, access_type);
 					END_PHASE_MEASURE(thread_id_, SELECT_PHASE);
@@ -132,12 +188,17 @@ namespace Cavalia{
 			}
 
 			// partition
-			bool SelectRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
+			RECONNAISSANCE_VIRTUAL bool SelectRecord(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecord *&record, const AccessType access_type){
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				TableRecord *t_record = NULL;
 				storage_manager_->tables_[table_id]->SelectRecord(partition_id, idx_id, secondary_key, t_record);
 				END_INDEX_TIME_MEASURE(thread_id_);
 				if (t_record != NULL) {
+#if defined(RECONNAISSANCE)
+					if (context->recon_rw_set_ != NULL && ValidateReconnaissance(context, table_id, t_record->record_->GetPrimaryKey()) == false) {
+						return false;
+					}
+#endif
 					BEGIN_PHASE_MEASURE(thread_id_, SELECT_PHASE);
 					bool rt = SelectRecordCC(context, table_id, t_record, record, access_type);
 					END_PHASE_MEASURE(thread_id_, SELECT_PHASE);
@@ -147,7 +208,7 @@ namespace Cavalia{
 			}
 
 			// shared
-			bool SelectRecords(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type) {
+			RECONNAISSANCE_VIRTUAL bool SelectRecords(TxnContext *context, const size_t &table_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type) {
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				storage_manager_->tables_[table_id]->SelectRecords(idx_id, secondary_key, t_records_);
 				END_INDEX_TIME_MEASURE(thread_id_);
@@ -159,7 +220,7 @@ namespace Cavalia{
 			}
 
 			// partition
-			bool SelectRecords(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type) {
+			RECONNAISSANCE_VIRTUAL bool SelectRecords(TxnContext *context, const size_t &table_id, const int &partition_id, const size_t &idx_id, const std::string &secondary_key, SchemaRecords *records, const AccessType access_type) {
 				BEGIN_INDEX_TIME_MEASURE(thread_id_);
 				storage_manager_->tables_[table_id]->SelectRecords(partition_id, idx_id, secondary_key, t_records_);
 				END_INDEX_TIME_MEASURE(thread_id_);
@@ -170,8 +231,8 @@ namespace Cavalia{
 				return rt;
 			}
 
-			bool CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str);
-			void AbortTransaction(TxnContext *context);
+			RECONNAISSANCE_VIRTUAL bool CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str);
+			RECONNAISSANCE_VIRTUAL void AbortTransaction(TxnContext *context);
 
 			void CleanUp(){
 #if defined(VALUE_LOGGING) || defined(COMMAND_LOGGING)
@@ -185,6 +246,11 @@ namespace Cavalia{
 				for (size_t i = 0; i < t_records->curr_size_; ++i) {
 					SchemaRecord **s_record = &(records->records_[i]);
 					TableRecord *t_record = t_records->records_[i];
+#if defined(RECONNAISSANCE)
+					if (context->recon_rw_set_ != NULL && ValidateReconnaissance(context, table_id, t_record->record_->GetPrimaryKey()) == false) {
+						return false;
+					}
+#endif
 					if (SelectRecordCC(context, table_id, t_record, *s_record, access_type) == false) {
 						return false;
 					}
@@ -192,9 +258,28 @@ namespace Cavalia{
 				return true;
 			}
 
+#if defined(RECONNAISSANCE)
+			// a reconnoitered transaction may only touch the items its reconnaissance run found,
+			// other transactions may be accessing the rest without concurrency control.
+			bool ValidateReconnaissance(TxnContext *context, const size_t &table_id, const char *primary_key, const size_t &key_size){
+				if (context->recon_rw_set_ == NULL || context->recon_rw_set_->Get(GetRecordHash(table_id, primary_key, key_size)) != NULL) {
+					return true;
+				}
+				is_reconnaissance_stale_ = true;
+				this->AbortTransaction(context);
+				return false;
+			}
+
+			bool ValidateReconnaissance(TxnContext *context, const size_t &table_id, const std::string &primary_key){
+				return ValidateReconnaissance(context, table_id, primary_key.data(), primary_key.size());
+			}
+#endif
+
 			#if defined(DYNAMIC_CC)
 				CC_FUNCTION_HEADERS(LockWait)
+				CC_FUNCTION_HEADERS(LockNoWait)
 				CC_FUNCTION_HEADERS(Occ)
+				CC_FUNCTION_HEADERS(Silo)
 			#endif
 
 			uint64_t GenerateScalableTimestamp(const uint64_t &curr_epoch, const uint64_t &max_rw_ts){
@@ -229,10 +314,60 @@ namespace Cavalia{
 				return commit_ts;
 			}
 
+			// local copies only live until the commit or abort of the current transaction, so with
+			// -DTXN_ARENA they are bumped out of a per-thread arena, the record right before its data.
+			SchemaRecord* AllocLocalRecord(const RecordSchema *schema_ptr){
+#if defined(TXN_ARENA)
+				char *local_ptr = txn_arena_.Alloc(kLocalRecordHeaderSize + schema_ptr->GetSchemaSize());
+				SchemaRecord *local_record = (SchemaRecord*)local_ptr;
+				new(local_record)SchemaRecord(schema_ptr, local_ptr + kLocalRecordHeaderSize);
+#else
+				char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
+				SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
+				new(local_record)SchemaRecord(schema_ptr, local_data);
+#endif
+				return local_record;
+			}
+
+			void FreeLocalRecord(SchemaRecord *local_record){
+#if defined(TXN_ARENA)
+				// reclaimed all at once by ReleaseLocalRecords.
+				local_record->~SchemaRecord();
+#else
+				MemAllocator::Free(local_record->data_ptr_);
+				local_record->~SchemaRecord();
+				MemAllocator::Free((char*)local_record);
+#endif
+			}
+
+			// called once the current transaction has committed or aborted.
+			void ReleaseLocalRecords(){
+#if defined(TXN_ARENA)
+				txn_arena_.Reset();
+#endif
+			}
+
+			// called with the write lock of a record whose delete commits. transactions that found the record
+			// before keep a valid pointer, it is freed once every worker has passed a quiescent point. records
+			// are kept under RECONNAISSANCE, whose partitioning threads read them without quiescing, and under
+			// DYNAMIC_CC, whose lock-based transactions do not quiesce.
+			void UnlinkRecord(const size_t &table_id, TableRecord *t_record){
+				storage_manager_->tables_[table_id]->DeleteRecord(t_record);
+#if !defined(RECONNAISSANCE) && !defined(DYNAMIC_CC)
+				GarbageCollector::RetireRecord(thread_id_, t_record);
+#endif
+			}
+
 		private:
 			TransactionManager(const TransactionManager &);
 			TransactionManager& operator=(const TransactionManager &);
 
+#if defined(RECONNAISSANCE)
+		public:
+			// set when the last transaction aborted because it strayed from its reconnaissance run.
+			bool is_reconnaissance_stale_;
+#endif
+
 		protected:
 			BaseStorageManager *const storage_manager_;
 			BaseLogger *const logger_;
@@ -243,14 +378,17 @@ namespace Cavalia{
 			bool is_first_access_;
 			uint64_t local_epoch_;
 			uint32_t local_ts_;
-			std::atomic<uint64_t> progress_ts_;
 			AccessList<kMaxAccessNum> access_list_;
 			TableRecords *t_records_;
+#if defined(TXN_ARENA)
+			static const size_t kLocalRecordHeaderSize = (sizeof(SchemaRecord) + 15) & ~(size_t)15;
+			BumpArena txn_arena_;
+#endif
 
 #if defined(BATCH_TIMESTAMP)
 			BatchTimestamp batch_ts_;
 #endif
-#if defined(SILO)
+#if defined(SILO) || defined(DYNAMIC_CC)
 			// write set.
 			AccessPtrList<kMaxAccessNum> write_list_;
 #endif
@@ -17,6 +17,10 @@ namespace Cavalia{
 			SchemaRecord *local_record_;
 			size_t table_id_;
 			uint64_t timestamp_;
+#if defined(MIXED_CC)
+			// whether wait_content_ of the record is held.
+			bool is_locked_;
+#endif
 		};
 
 		template<int N>
@@ -44,7 +48,7 @@ namespace Cavalia{
 			}
 
 		private:
-			static bool CompFunction(Access lhs, Access rhs){
+			static bool CompFunction(const Access &lhs, const Access &rhs){
 				return (uint64_t)(lhs.access_record_) < (uint64_t)(rhs.access_record_);
 			}
 
@@ -77,6 +81,22 @@ namespace Cavalia{
 				std::sort(accesses_, accesses_ + access_count_, CompFunction);
 			}
 
+			// whether an access to record is in the list, which must be sorted.
+			bool Contains(TableRecord *record) const {
+				size_t lower = 0;
+				size_t upper = access_count_;
+				while (lower < upper){
+					size_t middle = (lower + upper) / 2;
+					if ((uint64_t)(accesses_[middle]->access_record_) < (uint64_t)(record)){
+						lower = middle + 1;
+					}
+					else{
+						upper = middle;
+					}
+				}
+				return lower < access_count_ && accesses_[lower]->access_record_ == record;
+			}
+
 		private:
 			static bool CompFunction(Access *lhs, Access *rhs){
 				return (uint64_t)(lhs->access_record_) < (uint64_t)(rhs->access_record_);
@@ -2,20 +2,30 @@
 #ifndef __CAVALIA_DATABASE_TXN_CONTEXT_H__
 #define __CAVALIA_DATABASE_TXN_CONTEXT_H__
 
+#include <cstddef>
+
 namespace Cavalia{
 	namespace Database{
-		enum ConcurrencyControlType { CC_LOCK_WAIT, CC_LOCK_NO_WAIT, CC_OCC };
+		enum ConcurrencyControlType { CC_LOCK_WAIT, CC_LOCK_NO_WAIT, CC_OCC, CC_SILO };
+		struct ReadWriteSet;
 		struct ExeContext{
 			ExeContext() : is_adhoc_(false), is_retry_(false)
 			#if defined(DYNAMIC_CC)
 			, cc_type_(CC_LOCK_WAIT)
 			#endif
+			#if defined(RECONNAISSANCE)
+			, recon_rw_set_(NULL)
+			#endif
 			{}
 			bool is_adhoc_;
 			bool is_retry_;
 			#if defined(DYNAMIC_CC)
 			ConcurrencyControlType cc_type_;
 			#endif
+			#if defined(RECONNAISSANCE)
+			// items found by the reconnaissance run of the transaction, NULL if it declared them.
+			const ReadWriteSet *recon_rw_set_;
+			#endif
 		};
 
 		struct TxnContext {
@@ -23,10 +33,19 @@ namespace Cavalia{
 			#if defined(DYNAMIC_CC)
 			, cc_type_(CC_LOCK_WAIT) 
 			#endif
+			#if defined(RECONNAISSANCE)
+			, recon_rw_set_(NULL)
+			#endif
 			{}
 			void PassContext(const ExeContext &context){
 				is_adhoc_ = context.is_adhoc_;
 				is_retry_ = context.is_retry_;
+				#if defined(DYNAMIC_CC)
+				cc_type_ = context.cc_type_;
+				#endif
+				#if defined(RECONNAISSANCE)
+				recon_rw_set_ = context.recon_rw_set_;
+				#endif
 			}
 			size_t txn_type_;
 			bool is_read_only_;
@@ -36,6 +55,9 @@ namespace Cavalia{
 			#if defined(DYNAMIC_CC)
 			ConcurrencyControlType cc_type_;
 			#endif
+			#if defined(RECONNAISSANCE)
+			const ReadWriteSet *recon_rw_set_;
+			#endif
 		};
 	}
 }
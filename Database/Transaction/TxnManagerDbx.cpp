@@ -7,6 +7,7 @@ namespace Cavalia{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			Access *access = access_list_.NewAccess();
 			access->access_type_ = INSERT_ONLY;
 			access->access_record_ = tb_record;
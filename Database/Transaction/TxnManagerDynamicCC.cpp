@@ -8,8 +8,12 @@ namespace Cavalia{
 			switch(context->cc_type_) {
                 case CC_LOCK_WAIT:
                     return CC_INSERT_FUNCTION(LockWait)(context, table_id, primary_key, record);
+                case CC_LOCK_NO_WAIT:
+                    return CC_INSERT_FUNCTION(LockNoWait)(context, table_id, primary_key, record);
                 case CC_OCC:
                     return CC_INSERT_FUNCTION(Occ)(context, table_id, primary_key, record);
+                case CC_SILO:
+                    return CC_INSERT_FUNCTION(Silo)(context, table_id, primary_key, record);
                 default:
                     assert(false);
                     return true;
@@ -20,8 +24,12 @@ namespace Cavalia{
 			switch(context->cc_type_) {
                 case CC_LOCK_WAIT:
                     return CC_SELECT_FUNCTION(LockWait)(context, table_id, t_record, s_record, access_type);
+                case CC_LOCK_NO_WAIT:
+                    return CC_SELECT_FUNCTION(LockNoWait)(context, table_id, t_record, s_record, access_type);
                 case CC_OCC:
                     return CC_SELECT_FUNCTION(Occ)(context, table_id, t_record, s_record, access_type);
+                case CC_SILO:
+                    return CC_SELECT_FUNCTION(Silo)(context, table_id, t_record, s_record, access_type);
                 default:
                     assert(false);
                     return true;
@@ -32,8 +40,12 @@ namespace Cavalia{
 			switch(context->cc_type_) {
                 case CC_LOCK_WAIT:
                     return CC_COMMIT_FUNCTION(LockWait)(context, param, ret_str);
+                case CC_LOCK_NO_WAIT:
+                    return CC_COMMIT_FUNCTION(LockNoWait)(context, param, ret_str);
                 case CC_OCC:
                     return CC_COMMIT_FUNCTION(Occ)(context, param, ret_str);
+                case CC_SILO:
+                    return CC_COMMIT_FUNCTION(Silo)(context, param, ret_str);
                 default:
                     assert(false);
                     return true;
@@ -44,8 +56,12 @@ namespace Cavalia{
 			switch(context->cc_type_) {
                 case CC_LOCK_WAIT:
                     return CC_ABORT_FUNCTION(LockWait)(context);
+                case CC_LOCK_NO_WAIT:
+                    return CC_ABORT_FUNCTION(LockNoWait)(context);
                 case CC_OCC:
                     return CC_ABORT_FUNCTION(Occ)(context);
+                case CC_SILO:
+                    return CC_ABORT_FUNCTION(Silo)(context);
                 default:
                     assert(false);
             }
@@ -1,4 +1,4 @@
-#if defined(LOCK)
+#if defined(LOCK) || defined(DYNAMIC_CC)
 #include <iostream>
 #include "TransactionManager.h"
 
@@ -25,6 +25,7 @@ namespace Cavalia{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			if (tb_record->content_.TryWriteLock() == false) {
 				this->AbortTransaction(context);
 				return false;
@@ -69,9 +70,7 @@ namespace Cavalia{
 						return false;
 					}
 					const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-					char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-					SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-					new(local_record)SchemaRecord(schema_ptr, local_data);
+					SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 					t_record->record_->CopyTo(local_record);
 					Access *access = access_list_.NewAccess();
 					access->access_type_ = READ_WRITE;
@@ -111,9 +110,7 @@ namespace Cavalia{
 					{
 						//do we necessarily need a local copy? yes, because a transaction might abort after some modifications.
 						const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-						char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-						SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-						new(local_record)SchemaRecord(schema_ptr, local_data);
+						SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 						t_record->record_->CopyTo(local_record);
 						
 						Access *access = access_list_.NewAccess();
@@ -223,9 +220,7 @@ namespace Cavalia{
 						access_ptr->access_record_->content_.ReleaseWriteLock();
 						//clear memory of local copy of record
 						SchemaRecord *local_record_ptr = access_ptr->local_record_;
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 						break;
 					}
 					#if defined(SELECTIVE_CC)
@@ -237,9 +232,7 @@ namespace Cavalia{
 						{
 							//clear memory of local copy of record
 							SchemaRecord *local_record_ptr = access_ptr->local_record_;
-							MemAllocator::Free(local_record_ptr->data_ptr_);
-							local_record_ptr->~SchemaRecord();
-							MemAllocator::Free((char*)local_record_ptr);
+							FreeLocalRecord(local_record_ptr);
 							break;
 						}
 					#endif
@@ -250,6 +243,7 @@ namespace Cavalia{
 			}
 
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 			return true;
@@ -289,9 +283,7 @@ namespace Cavalia{
 					{
 						global_record_ptr->CopyFrom(local_record_ptr);
 						content_ref.ReleaseWriteLock();
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 						break;
 					}
 					#if defined(SELECTIVE_CC)
@@ -308,9 +300,7 @@ namespace Cavalia{
 						case NO_CC_READ_WRITE:
 						{
 							global_record_ptr->CopyFrom(local_record_ptr);
-							MemAllocator::Free(local_record_ptr->data_ptr_);
-							local_record_ptr->~SchemaRecord();
-							MemAllocator::Free((char*)local_record_ptr);
+							FreeLocalRecord(local_record_ptr);
 							break;
 						}
 						case NO_CC_READ_ONLY:
@@ -322,6 +312,7 @@ namespace Cavalia{
 				}
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 		}
 	}
@@ -12,6 +12,7 @@ namespace Cavalia {
 			// insert with visibility bit set to false.
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			tb_record->record_->is_visible_ = true;
 			Access *access = hot_access_list_.NewAccess();
 			access->access_type_ = INSERT_ONLY;
@@ -37,6 +37,7 @@ namespace Cavalia{
 			}
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			tb_record->record_->is_visible_ = true;
 			Access *access = access_list_.NewAccess();
 			access->access_type_ = INSERT_ONLY;
@@ -99,9 +100,7 @@ namespace Cavalia{
 						while (!lock_ready);
 						END_CC_WAIT_TIME_MEASURE(thread_id_);
 						const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-						char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-						SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-						new(local_record)SchemaRecord(schema_ptr, local_data);
+						SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 						t_record->record_->CopyTo(local_record);
 						Access *access = access_list_.NewAccess();
 						access->access_type_ = READ_WRITE;
@@ -145,9 +144,7 @@ namespace Cavalia{
 					case NO_CC_READ_WRITE:
 					{
 						const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-						char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-						SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-						new(local_record)SchemaRecord(schema_ptr, local_data);
+						SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 						t_record->record_->CopyTo(local_record);
 						Access *access = access_list_.NewAccess();
 						access->access_type_ = NO_CC_READ_WRITE;
@@ -243,9 +240,7 @@ namespace Cavalia{
 					case READ_WRITE: 
 					{
 						access_ptr->access_record_->wait_content_.ReleaseLock(start_timestamp_);
-						MemAllocator::Free(access_ptr->local_record_->data_ptr_);
-						access_ptr->local_record_->~SchemaRecord();
-						MemAllocator::Free((char*)access_ptr->local_record_);
+						FreeLocalRecord(access_ptr->local_record_);
 						break;
 					}
 					case DELETE_ONLY:
@@ -256,9 +251,7 @@ namespace Cavalia{
 					#if defined(SELECTIVE_CC)
 						case NO_CC_READ_WRITE:
 						{
-							MemAllocator::Free(access_ptr->local_record_->data_ptr_);
-							access_ptr->local_record_->~SchemaRecord();
-							MemAllocator::Free((char*)access_ptr->local_record_);
+							FreeLocalRecord(access_ptr->local_record_);
 							break;
 						}
 						case NO_CC_READ_ONLY:
@@ -270,6 +263,7 @@ namespace Cavalia{
 				}
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 			is_first_access_ = true;
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
@@ -295,9 +289,7 @@ namespace Cavalia{
 					{
 						access_ptr->access_record_->wait_content_.ReleaseLock(start_timestamp_);
 						access_ptr->access_record_->record_->CopyFrom(access_ptr->local_record_);
-						MemAllocator::Free(access_ptr->local_record_->data_ptr_);
-						access_ptr->local_record_->~SchemaRecord();
-						MemAllocator::Free((char*)access_ptr->local_record_);
+						FreeLocalRecord(access_ptr->local_record_);
 						break;
 					}
 					case INSERT_ONLY: 
@@ -315,9 +307,7 @@ namespace Cavalia{
 						case NO_CC_READ_WRITE:
 						{
 							access_ptr->access_record_->record_->CopyFrom(access_ptr->local_record_);
-							MemAllocator::Free(access_ptr->local_record_->data_ptr_);
-							access_ptr->local_record_->~SchemaRecord();
-							MemAllocator::Free((char*)access_ptr->local_record_);
+							FreeLocalRecord(access_ptr->local_record_);
 							break;
 						}
 						case NO_CC_DELETE_ONLY:
@@ -338,6 +328,7 @@ namespace Cavalia{
 				}
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 		}
 	}
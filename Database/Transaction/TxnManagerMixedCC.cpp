@@ -0,0 +1,297 @@
+#if defined(MIXED_CC)
+#include "TransactionManager.h"
+
+namespace Cavalia {
+	namespace Database {
+		/*
+		** Mixed Concurrency Control:
+		** --------------------------
+		** Enabled by -DMIXED_CC
+		**
+		** Chooses the protocol per access rather than per batch, in the spirit of MOCC. Every record keeps a
+		** temperature that rises whenever a transaction fails validation on it and cools down as transactions
+		** get through it. Accesses to cold records are optimistic and only remember the timestamp of content_,
+		** as in OCC. Accesses to hot records first take the lock of wait_content_ under wait-die, as in
+		** LOCK_WAIT, so that transactions queue on the record instead of invalidating one another. Writes are
+		** buffered and every access is validated at commit as in OCC, which keeps a mixed access list
+		** serializable whatever mode the other transactions chose for the same record; the early locks only
+		** keep conflicts on hot records from turning into aborts.
+		*/
+
+		bool TransactionManager::InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record) {
+			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
+			// insert with visibility bit set to false.
+			record->is_visible_ = false;
+			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
+			Access *access = access_list_.NewAccess();
+			access->access_type_ = INSERT_ONLY;
+			access->access_record_ = tb_record;
+			access->local_record_ = NULL;
+			access->table_id_ = table_id;
+			access->timestamp_ = 0;
+			access->is_locked_ = false;
+			END_PHASE_MEASURE(thread_id_, INSERT_PHASE);
+			return true;
+		}
+
+		bool TransactionManager::SelectRecordCC(TxnContext *context, const size_t &table_id, TableRecord *t_record, SchemaRecord *&s_record, const AccessType access_type) {
+			bool is_hot = false;
+			LockType lock_type = WRITE_LOCK;
+			switch (access_type) {
+				case READ_ONLY:
+					lock_type = READ_LOCK;
+					is_hot = t_record->temperature_.IsHot();
+					break;
+				case READ_WRITE:
+				case DELETE_ONLY:
+					is_hot = t_record->temperature_.IsHot();
+					break;
+				#if defined(SELECTIVE_CC)
+					case NO_CC_READ_ONLY:
+					case NO_CC_READ_WRITE:
+					case NO_CC_DELETE_ONLY:
+						break;
+				#endif
+				default:
+					assert(false);
+					return true;
+			}
+
+			if (is_hot == true) {
+				// the timestamp orders the transaction for wait-die, it is kept across retries.
+				if (is_first_access_ == true) {
+					BEGIN_CC_TS_ALLOC_TIME_MEASURE(thread_id_);
+					#if defined(BATCH_TIMESTAMP)
+						if (!batch_ts_.IsAvailable()){
+							batch_ts_.InitTimestamp(GlobalTimestamp::GetBatchMonotoneTimestamp());
+						}
+						start_timestamp_ = batch_ts_.GetTimestamp();
+					#else
+						start_timestamp_ = GlobalTimestamp::GetMonotoneTimestamp();
+					#endif
+					is_first_access_ = false;
+					END_CC_TS_ALLOC_TIME_MEASURE(thread_id_);
+				}
+				volatile bool lock_ready = true;
+				if (t_record->wait_content_.AcquireLock(start_timestamp_, lock_type, &lock_ready) == false) {
+					this->AbortTransaction(context);
+					return false;
+				}
+				BEGIN_CC_WAIT_TIME_MEASURE(thread_id_);
+				while (!lock_ready);
+				END_CC_WAIT_TIME_MEASURE(thread_id_);
+			}
+
+			Access *access = access_list_.NewAccess();
+			access->access_type_ = access_type;
+			access->access_record_ = t_record;
+			access->local_record_ = NULL;
+			access->table_id_ = table_id;
+			access->is_locked_ = is_hot;
+			switch (access_type) {
+				case READ_WRITE:
+				#if defined(SELECTIVE_CC)
+					case NO_CC_READ_WRITE:
+				#endif
+				{
+					// copy data
+					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
+					SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
+					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					access->timestamp_ = t_record->content_.GetTimestamp();
+					COMPILER_MEMORY_FENCE;
+					local_record->CopyFrom(t_record->record_);
+					access->local_record_ = local_record;
+					// reset returned record.
+					s_record = local_record;
+					return true;
+				}
+				default:
+				{
+					access->timestamp_ = t_record->content_.GetTimestamp();
+					s_record = t_record->record_;
+					return true;
+				}
+			}
+		}
+
+		bool TransactionManager::CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str) {
+			bool is_success = true;
+			size_t lock_count = 0;
+			BEGIN_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
+			// Step 1: Acquire locks and validate, whatever the mode of the access
+			access_list_.Sort();
+			for (size_t i = 0; i < access_list_.access_count_; ++i) {
+				++lock_count;
+				Access *access_ptr = access_list_.GetAccess(i);
+				auto &content_ref = access_ptr->access_record_->content_;
+				switch (access_ptr->access_type_) {
+					case READ_ONLY:
+					{
+						content_ref.AcquireReadLock();
+						if (content_ref.GetTimestamp() != access_ptr->timestamp_) {
+							UPDATE_CC_ABORT_COUNT(thread_id_, context->txn_type_, access_ptr->table_id_);
+							access_ptr->access_record_->temperature_.Heat();
+							is_success = false;
+						}
+						break;
+					}
+					case READ_WRITE:
+					{
+						content_ref.AcquireWriteLock();
+						if (content_ref.GetTimestamp() != access_ptr->timestamp_) {
+							UPDATE_CC_ABORT_COUNT(thread_id_, context->txn_type_, access_ptr->table_id_);
+							access_ptr->access_record_->temperature_.Heat();
+							is_success = false;
+						}
+						break;
+					}
+					case INSERT_ONLY:
+					case DELETE_ONLY:
+					{
+						content_ref.AcquireWriteLock();
+						break;
+					}
+					default:
+						break;
+				}
+				if (is_success == false) {
+					break;
+				}
+			}
+
+			// Step 2: If success, then overwrite and commit
+			if (is_success == true) {
+				BEGIN_CC_TS_ALLOC_TIME_MEASURE(thread_id_);
+				uint64_t curr_epoch = Epoch::GetEpoch();
+				#if defined(SCALABLE_TIMESTAMP)
+					uint64_t max_rw_ts = 0;
+					for (size_t i = 0; i < access_list_.access_count_; ++i){
+						Access *access_ptr = access_list_.GetAccess(i);
+						if (access_ptr->timestamp_ > max_rw_ts){
+							max_rw_ts = access_ptr->timestamp_;
+						}
+					}
+					uint64_t commit_ts = GenerateScalableTimestamp(curr_epoch, max_rw_ts);
+				#else
+					uint64_t commit_ts = GenerateMonotoneTimestamp(curr_epoch, GlobalTimestamp::GetMonotoneTimestamp());
+				#endif
+				END_CC_TS_ALLOC_TIME_MEASURE(thread_id_);
+
+				for (size_t i = 0; i < access_list_.access_count_; ++i) {
+					Access *access_ptr = access_list_.GetAccess(i);
+					SchemaRecord *global_record_ptr = access_ptr->access_record_->record_;
+					auto &content_ref = access_ptr->access_record_->content_;
+					switch (access_ptr->access_type_) {
+						case READ_WRITE:
+						#if defined(SELECTIVE_CC)
+							case NO_CC_READ_WRITE:
+						#endif
+						{
+							assert(commit_ts > access_ptr->timestamp_);
+							global_record_ptr->InstallFrom(access_ptr->local_record_);
+							COMPILER_MEMORY_FENCE;
+							content_ref.SetTimestamp(commit_ts);
+							break;
+						}
+						case INSERT_ONLY:
+						{
+							assert(commit_ts > access_ptr->timestamp_);
+							global_record_ptr->is_visible_ = true;
+							COMPILER_MEMORY_FENCE;
+							content_ref.SetTimestamp(commit_ts);
+							break;
+						}
+						case DELETE_ONLY:
+						#if defined(SELECTIVE_CC)
+							case NO_CC_DELETE_ONLY:
+						#endif
+						{
+							assert(commit_ts > access_ptr->timestamp_);
+							global_record_ptr->is_visible_ = false;
+							COMPILER_MEMORY_FENCE;
+							content_ref.SetTimestamp(commit_ts);
+							break;
+						}
+						default:
+							break;
+					}
+				}
+
+				#if defined(VALUE_LOGGING)
+					logger_->CommitTransaction(this->thread_id_, curr_epoch, commit_ts, access_list_);
+				#elif defined(COMMAND_LOGGING)
+					if (context->is_adhoc_ == true){
+						logger_->CommitTransaction(this->thread_id_, curr_epoch, commit_ts, access_list_);
+					}
+					logger_->CommitTransaction(this->thread_id_, curr_epoch, commit_ts, context->txn_type_, param);
+				#endif
+			}
+
+			// Step 3: Release locks and free memory
+			for (size_t i = 0; i < lock_count; ++i) {
+				Access *access_ptr = access_list_.GetAccess(i);
+				switch (access_ptr->access_type_) {
+					case READ_ONLY:
+						access_ptr->access_record_->content_.ReleaseReadLock();
+						break;
+					case READ_WRITE:
+					case INSERT_ONLY:
+					case DELETE_ONLY:
+						access_ptr->access_record_->content_.ReleaseWriteLock();
+						break;
+					default:
+						break;
+				}
+			}
+			for (size_t i = 0; i < access_list_.access_count_; ++i) {
+				Access *access_ptr = access_list_.GetAccess(i);
+				if (access_ptr->local_record_ != NULL) {
+					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					SchemaRecord *local_record_ptr = access_ptr->local_record_;
+					FreeLocalRecord(local_record_ptr);
+					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+				}
+				if (access_ptr->is_locked_ == true) {
+					access_ptr->access_record_->wait_content_.ReleaseLock(start_timestamp_);
+				}
+				// records heated by validation failures but still below kHotTemperature cool as well.
+				if (is_success == true) {
+					access_ptr->access_record_->temperature_.Cool();
+				}
+			}
+			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
+			access_list_.Clear();
+			// a transaction that failed validation keeps its wait-die priority for the retry.
+			if (is_success == true) {
+				is_first_access_ = true;
+			}
+			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
+			return is_success;
+		}
+
+		// only called when the wait-die lock of a hot record is denied, nothing has been written yet.
+		void TransactionManager::AbortTransaction(TxnContext* context) {
+			for (size_t i = 0; i < access_list_.access_count_; ++i) {
+				Access *access_ptr = access_list_.GetAccess(i);
+				if (access_ptr->local_record_ != NULL) {
+					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					SchemaRecord *local_record_ptr = access_ptr->local_record_;
+					FreeLocalRecord(local_record_ptr);
+					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+				}
+				if (access_ptr->is_locked_ == true) {
+					access_ptr->access_record_->wait_content_.ReleaseLock(start_timestamp_);
+				}
+			}
+			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
+			access_list_.Clear();
+		}
+	}
+}
+
+#endif
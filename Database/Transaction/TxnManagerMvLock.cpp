@@ -7,6 +7,7 @@ namespace Cavalia{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 			//if (tb_record->content_.TryWriteLock() == false){
 			//	this->AbortTransaction();
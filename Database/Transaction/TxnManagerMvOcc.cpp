@@ -7,6 +7,7 @@ namespace Cavalia{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			// the to-be-inserted record may have already existed.
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 				Access *access = access_list_.NewAccess();
@@ -95,6 +96,7 @@ namespace Cavalia{
 				}
 				read_only_set_.clear();
 				is_first_access_ = true;
+				GarbageCollector::Quiesce(thread_id_);
 				END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 				return true;
 			}
@@ -151,7 +153,11 @@ namespace Cavalia{
 					auto &content_ref = access_ptr->access_record_->content_;
 					if (access_ptr->access_type_ == READ_WRITE){
 						assert(commit_ts > access_ptr->timestamp_);
-						content_ref.WriteAccess(commit_ts, local_record_ptr->data_ptr_);
+						MvHistoryEntry *garbage = content_ref.WriteAccess(commit_ts, local_record_ptr->data_ptr_);
+						if (garbage != NULL){
+							GarbageCollector::Retire(thread_id_, garbage, local_record_ptr->schema_ptr_->GetSchemaSize());
+						}
+						GarbageCollector::RecordInstall(thread_id_, content_ref.GetHistoryLength());
 					}
 					else if (access_ptr->access_type_ == INSERT_ONLY){
 						global_record_ptr->is_visible_ = true;
@@ -217,6 +223,7 @@ namespace Cavalia{
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
 			access_list_.Clear();
+			GarbageCollector::Quiesce(thread_id_);
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 			return is_success;
 		}
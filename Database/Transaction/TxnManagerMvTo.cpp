@@ -21,6 +21,7 @@ namespace Cavalia{
 			// we assume that concurrent txns will not read this insert record.
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			// upsert.
 			storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record);
 			Access *access = access_list_.NewAccess();
@@ -125,6 +126,7 @@ namespace Cavalia{
 				}
 				read_only_set_.clear();
 				is_first_access_ = true;
+				GarbageCollector::Quiesce(thread_id_);
 				END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 				return true;
 			}
@@ -135,7 +137,12 @@ namespace Cavalia{
 				if (access_ptr->access_type_ == READ_WRITE){
 					assert(access_ptr->access_record_ != NULL);
 					//access_ptr->access_record_->content_.RequestCommit(start_timestamp_);
-					access_ptr->access_record_->content_.RequestCommit(start_timestamp_, access_ptr->local_record_->data_ptr_);
+					auto &content_ref = access_ptr->access_record_->content_;
+					MvHistoryEntry *garbage = content_ref.RequestCommit(start_timestamp_, access_ptr->local_record_->data_ptr_);
+					if (garbage != NULL){
+						GarbageCollector::Retire(thread_id_, garbage, access_ptr->local_record_->schema_ptr_->GetSchemaSize());
+					}
+					GarbageCollector::RecordInstall(thread_id_, content_ref.GetHistoryLength());
 					access_ptr->local_record_->data_ptr_ = NULL;
 					access_ptr->local_record_->~SchemaRecord();
 					MemAllocator::Free((char*)access_ptr->local_record_);
@@ -152,6 +159,7 @@ namespace Cavalia{
 			//logger_->CommitTransaction(txn_type, param);
 			GlobalTimestamp::SetThreadTimestamp(thread_id_, start_timestamp_);
 			is_first_access_ = true;
+			GarbageCollector::Quiesce(thread_id_);
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 			return true;
 		}
@@ -180,6 +188,7 @@ namespace Cavalia{
 			access_list_.Clear();
 			GlobalTimestamp::SetThreadTimestamp(thread_id_, start_timestamp_);
 			is_first_access_ = true;
+			GarbageCollector::Quiesce(thread_id_);
 		}
 	}
 }
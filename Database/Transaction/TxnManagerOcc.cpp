@@ -27,6 +27,7 @@ namespace Cavalia {
 			// insert with visibility bit set to false.
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			Access *access = access_list_.NewAccess();
 			access->access_type_ = INSERT_ONLY;
 			access->access_record_ = tb_record;
@@ -63,9 +64,7 @@ namespace Cavalia {
 					// copy data
 					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 					const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-					char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-					SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-					new(local_record)SchemaRecord(schema_ptr, local_data);
+					SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 					access->timestamp_ = t_record->content_.GetTimestamp();
 					COMPILER_MEMORY_FENCE;
@@ -109,9 +108,7 @@ namespace Cavalia {
 						// copy data
 						BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 						const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-						char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-						SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-						new(local_record)SchemaRecord(schema_ptr, local_data);
+						SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 						END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 						local_record->CopyFrom(t_record->record_);
 						COMPILER_MEMORY_FENCE
@@ -231,7 +228,7 @@ namespace Cavalia {
 						case READ_WRITE: 
 						{
 							assert(commit_ts > access_ptr->timestamp_);
-							global_record_ptr->CopyFrom(local_record_ptr);
+							global_record_ptr->InstallFrom(local_record_ptr);
 							COMPILER_MEMORY_FENCE;
 							content_ref.SetTimestamp(commit_ts);
 							break;
@@ -250,13 +247,14 @@ namespace Cavalia {
 							global_record_ptr->is_visible_ = false;
 							COMPILER_MEMORY_FENCE;
 							content_ref.SetTimestamp(commit_ts);
+							UnlinkRecord(access_ptr->table_id_, access_ptr->access_record_);
 							break;
 						}
 						#if defined(SELECTIVE_CC)
 							case NO_CC_READ_WRITE: 
 							{
 								assert(commit_ts > access_ptr->timestamp_);
-								global_record_ptr->CopyFrom(local_record_ptr);
+								global_record_ptr->InstallFrom(local_record_ptr);
 								COMPILER_MEMORY_FENCE
 								content_ref.SetTimestamp(commit_ts);
 								break;
@@ -275,6 +273,7 @@ namespace Cavalia {
 								global_record_ptr->is_visible_ = false;
 								COMPILER_MEMORY_FENCE
 								content_ref.SetTimestamp(commit_ts);
+								UnlinkRecord(access_ptr->table_id_, access_ptr->access_record_);
 								break;
 							}
 						#endif
@@ -309,9 +308,7 @@ namespace Cavalia {
 							access_ptr->access_record_->content_.ReleaseWriteLock();
 							BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 							SchemaRecord *local_record_ptr = access_ptr->local_record_;
-							MemAllocator::Free(local_record_ptr->data_ptr_);
-							local_record_ptr->~SchemaRecord();
-							MemAllocator::Free((char*)local_record_ptr);
+							FreeLocalRecord(local_record_ptr);
 							END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 							break;
 						}
@@ -326,9 +323,7 @@ namespace Cavalia {
 							{
 								BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 								SchemaRecord *local_record_ptr = access_ptr->local_record_;
-								MemAllocator::Free(local_record_ptr->data_ptr_);
-								local_record_ptr->~SchemaRecord();
-								MemAllocator::Free((char*)local_record_ptr);
+								FreeLocalRecord(local_record_ptr);
 								END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 								break;
 							}
@@ -342,7 +337,9 @@ namespace Cavalia {
 					}
 				}
 				assert(access_list_.access_count_ <= kMaxAccessNum);
+				ReleaseLocalRecords();
 				access_list_.Clear();
+				GarbageCollector::Quiesce(thread_id_);
 			}
 			
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
@@ -355,7 +352,20 @@ namespace Cavalia {
 			void TransactionManager::AbortTransaction(TxnContext* context) 
 		#endif
 		{
-			assert(false);
+			// nothing is locked before the commit, only the local copies have to go.
+			for (size_t i = 0; i < access_list_.access_count_; ++i) {
+				Access *access_ptr = access_list_.GetAccess(i);
+				if (access_ptr->local_record_ != NULL) {
+					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					SchemaRecord *local_record_ptr = access_ptr->local_record_;
+					FreeLocalRecord(local_record_ptr);
+					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+				}
+			}
+			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
+			access_list_.Clear();
+			GarbageCollector::Quiesce(thread_id_);
 		}
 	}
 }
@@ -8,6 +8,7 @@ namespace Cavalia {
 			// insert with visibility bit set to false.
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			// the to-be-inserted record may have already existed.
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 			Access *access = access_list_.NewAccess();
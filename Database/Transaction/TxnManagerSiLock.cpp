@@ -11,6 +11,7 @@ namespace Cavalia{
 			}
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 			if (tb_record->content_.TryWriteLock() == false){
 				this->AbortTransaction();
@@ -1,13 +1,31 @@
-#if defined(SILO)
+#if defined(SILO) || defined(DYNAMIC_CC)
 #include "TransactionManager.h"
 
 namespace Cavalia{
 	namespace Database{
-		bool TransactionManager::InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record){
+		/*
+		** Silo:
+		** -----
+		** Enabled by -DSILO compiler flag
+		**
+		** OCC following Silo's commit protocol [TZK+13]. Only the write set is sorted and locked at commit,
+		** the read set is validated without taking any lock. With -DSILO a record carries a TidContent, whose
+		** write lock is a bit of the timestamp word, so validating a read is a single load that tells whether
+		** the record changed or is being written by another transaction. Under DYNAMIC_CC the records keep
+		** their LockContent, shared with the other protocols, and the same steps run on its RWLock.
+		*/
+
+		#if defined(DYNAMIC_CC)
+			CC_INSERT_FUNCTION_HEADER_SPECIFIED(Silo)
+		#else
+			bool TransactionManager::InsertRecord(TxnContext *context, const size_t &table_id, const std::string &primary_key, SchemaRecord *record)
+		#endif
+		{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			// insert with visibility bit set to false.
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 				Access *access = access_list_.NewAccess();
 				access->access_type_ = INSERT_ONLY;
@@ -26,8 +44,26 @@ namespace Cavalia{
 			}*/
 		}
 
-		bool TransactionManager::SelectRecordCC(TxnContext *context, const size_t &table_id, TableRecord *t_record, SchemaRecord *&s_record, const AccessType access_type) {
-			if (access_type == READ_ONLY){
+		#if defined(DYNAMIC_CC)
+			CC_SELECT_FUNCTION_HEADER_SPECIFIED(Silo)
+		#else
+			bool TransactionManager::SelectRecordCC(TxnContext *context, const size_t &table_id, TableRecord *t_record, SchemaRecord *&s_record, const AccessType access_type)
+		#endif
+		{
+			AccessType silo_access_type = access_type;
+		#if defined(SELECTIVE_CC)
+			// items nobody else accesses in the atomic-batch are validated like the others, it is cheap and never fails.
+			if (silo_access_type == NO_CC_READ_ONLY){
+				silo_access_type = READ_ONLY;
+			}
+			else if (silo_access_type == NO_CC_READ_WRITE){
+				silo_access_type = READ_WRITE;
+			}
+			else if (silo_access_type == NO_CC_DELETE_ONLY){
+				silo_access_type = DELETE_ONLY;
+			}
+		#endif
+			if (silo_access_type == READ_ONLY){
 				Access *access = access_list_.NewAccess();
 				access->access_type_ = READ_ONLY;
 				access->access_record_ = t_record;
@@ -37,16 +73,14 @@ namespace Cavalia{
 				s_record = t_record->record_;
 				return true;
 			}
-			else if (access_type == READ_WRITE){
+			else if (silo_access_type == READ_WRITE){
 				Access *access = access_list_.NewAccess();
 				access->access_type_ = READ_WRITE;
 				access->access_record_ = t_record;
 				// copy data
 				BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 				const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-				char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-				SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-				new(local_record)SchemaRecord(schema_ptr, local_data);
+				SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 				END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 				access->timestamp_ = t_record->content_.GetTimestamp();
 				COMPILER_MEMORY_FENCE;
@@ -58,7 +92,7 @@ namespace Cavalia{
 				s_record = local_record;
 				return true;
 			}
-			else if (access_type == DELETE_ONLY){
+			else if (silo_access_type == DELETE_ONLY){
 				Access *access = access_list_.NewAccess();
 				access->access_type_ = DELETE_ONLY;
 				access->access_record_ = t_record;
@@ -75,7 +109,12 @@ namespace Cavalia{
 			}
 		}
 
-		bool TransactionManager::CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str){
+		#if defined(DYNAMIC_CC)
+			CC_COMMIT_FUNCTION_HEADER_SPECIFIED(Silo)
+		#else
+			bool TransactionManager::CommitTransaction(TxnContext *context, TxnParam *param, CharArray &ret_str)
+		#endif
+		{
 			BEGIN_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 			// step 1: acquire write lock.
 			write_list_.Sort();
@@ -101,8 +140,9 @@ namespace Cavalia{
 					}
 				}
 				else if (access_ptr->access_type_ == READ_ONLY){
-					if (content_ref.ExistsWriteLock() || 
-						content_ref.GetTimestamp() != access_ptr->timestamp_){
+					bool is_locked = false;
+					if (content_ref.GetTimestamp(is_locked) != access_ptr->timestamp_ ||
+						(is_locked == true && write_list_.Contains(access_ptr->access_record_) == false)){
 						is_success = false;
 						break;
 					}
@@ -135,7 +175,7 @@ namespace Cavalia{
 					SchemaRecord *local_record_ptr = access_ptr->local_record_;
 					auto &content_ref = access_ptr->access_record_->content_;
 					if (access_ptr->access_type_ == READ_WRITE){
-						global_record_ptr->CopyFrom(local_record_ptr);
+						global_record_ptr->InstallFrom(local_record_ptr);
 						COMPILER_MEMORY_FENCE;
 						content_ref.SetTimestamp(commit_ts);
 					}
@@ -148,6 +188,7 @@ namespace Cavalia{
 						global_record_ptr->is_visible_ = false;
 						COMPILER_MEMORY_FENCE;
 						content_ref.SetTimestamp(commit_ts);
+						UnlinkRecord(access_ptr->table_id_, access_ptr->access_record_);
 					}
 				}
 				// commit.
@@ -167,9 +208,7 @@ namespace Cavalia{
 						access_ptr->access_record_->content_.ReleaseWriteLock();
 						BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 						SchemaRecord *local_record_ptr = access_ptr->local_record_;
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 						END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 					}
 					else{
@@ -187,9 +226,7 @@ namespace Cavalia{
 						access_ptr->access_record_->content_.ReleaseWriteLock();
 						BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 						SchemaRecord *local_record_ptr = access_ptr->local_record_;
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 						END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
 					}
 					else{
@@ -200,13 +237,34 @@ namespace Cavalia{
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
 			write_list_.Clear();
+			ReleaseLocalRecords();
 			access_list_.Clear();
+			GarbageCollector::Quiesce(thread_id_);
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
 			return is_success;
 		}
 
-		void TransactionManager::AbortTransaction() {
-			assert(false);
+		#if defined(DYNAMIC_CC)
+			CC_ABORT_FUNCTION_HEADER_SPECIFIED(Silo)
+		#else
+			void TransactionManager::AbortTransaction(TxnContext *context)
+		#endif
+		{
+			// nothing is locked before the commit, only the local copies have to go.
+			for (size_t i = 0; i < access_list_.access_count_; ++i) {
+				Access *access_ptr = access_list_.GetAccess(i);
+				if (access_ptr->local_record_ != NULL) {
+					BEGIN_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+					SchemaRecord *local_record_ptr = access_ptr->local_record_;
+					FreeLocalRecord(local_record_ptr);
+					END_CC_MEM_ALLOC_TIME_MEASURE(thread_id_);
+				}
+			}
+			assert(access_list_.access_count_ <= kMaxAccessNum);
+			write_list_.Clear();
+			ReleaseLocalRecords();
+			access_list_.Clear();
+			GarbageCollector::Quiesce(thread_id_);
 		}
 	}
 }
@@ -20,6 +20,7 @@ namespace Cavalia{
 			}
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 				tb_record->record_->is_visible_ = true;
 				Access *access = access_list_.NewAccess();
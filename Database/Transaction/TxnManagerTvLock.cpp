@@ -7,6 +7,7 @@ namespace Cavalia{
 			BEGIN_PHASE_MEASURE(thread_id_, INSERT_PHASE);
 			record->is_visible_ = false;
 			TableRecord *tb_record = new TableRecord(record);
+			tb_record->is_inserted_ = true;
 			//if (storage_manager_->tables_[table_id]->InsertRecord(primary_key, tb_record) == true){
 			//if (tb_record->content_.TryWriteLock() == false){
 			//	this->AbortTransaction();
@@ -55,9 +56,7 @@ namespace Cavalia{
 				else {
 					// return local copy.
 					const RecordSchema *schema_ptr = t_record->record_->schema_ptr_;
-					char *local_data = MemAllocator::Alloc(schema_ptr->GetSchemaSize());
-					SchemaRecord *local_record = (SchemaRecord*)MemAllocator::Alloc(sizeof(SchemaRecord));
-					new(local_record)SchemaRecord(schema_ptr, local_data);
+					SchemaRecord *local_record = AllocLocalRecord(schema_ptr);
 					t_record->record_->CopyTo(local_record);
 					Access *access = access_list_.NewAccess();
 					access->access_type_ = READ_WRITE;
@@ -99,7 +98,7 @@ namespace Cavalia{
 					Access *access_ptr = access_list_.GetAccess(i);
 					if (access_ptr->access_type_ == READ_WRITE){
 						// install from local copy.
-						access_ptr->access_record_->record_->CopyFrom(access_ptr->local_record_);
+						access_ptr->access_record_->record_->InstallFrom(access_ptr->local_record_);
 					}
 					else if (access_ptr->access_type_ == INSERT_ONLY){
 						// install from local copy.
@@ -130,9 +129,7 @@ namespace Cavalia{
 					Access *access_ptr = access_list_.GetAccess(i);
 					if (access_ptr->access_type_ == READ_WRITE){
 						SchemaRecord *local_record_ptr = access_ptr->local_record_;
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 					}
 				}
 			}
@@ -141,13 +138,12 @@ namespace Cavalia{
 					Access *access_ptr = access_list_.GetAccess(i);
 					if (access_ptr->access_type_ == READ_WRITE){
 						SchemaRecord *local_record_ptr = access_ptr->local_record_;
-						MemAllocator::Free(local_record_ptr->data_ptr_);
-						local_record_ptr->~SchemaRecord();
-						MemAllocator::Free((char*)local_record_ptr);
+						FreeLocalRecord(local_record_ptr);
 					}
 				}
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 			// for tvlock, no need to set is_first_access.
 			END_PHASE_MEASURE(thread_id_, COMMIT_PHASE);
@@ -162,12 +158,11 @@ namespace Cavalia{
 				}
 				else if (access_ptr->access_type_ == READ_WRITE){
 					access_ptr->access_record_->content_.ReleaseWriteLock();
-					MemAllocator::Free(access_ptr->local_record_->data_ptr_);
-					access_ptr->local_record_->~SchemaRecord();
-					MemAllocator::Free((char*)access_ptr->local_record_);
+					FreeLocalRecord(access_ptr->local_record_);
 				}
 			}
 			assert(access_list_.access_count_ <= kMaxAccessNum);
+			ReleaseLocalRecords();
 			access_list_.Clear();
 		}
 	}
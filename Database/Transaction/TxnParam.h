@@ -14,17 +14,22 @@ namespace Cavalia{
 		struct ReadWriteSet;
 		class TxnParam {
 		public:
-			TxnParam() : data_(NULL) {}
+			TxnParam() : data_(NULL), recon_rw_set_(NULL), is_reconnoitered_(false) {}
 			virtual ~TxnParam(){}
 			virtual uint64_t GetHashCode() const = 0;
 			virtual void Serialize(CharArray& serial_str) const = 0;
 			virtual void Serialize(char *buffer, size_t &buffer_size) const = 0;
 			virtual void Deserialize(const CharArray& serial_str) = 0;
-			virtual void BuildReadWriteSet(ReadWriteSet& batch_rw_set) = 0;
-			virtual ReadWriteSet& GetReadWriteSet() = 0;
+			// declares the items the transaction accesses. returns false if they cannot be told from
+			// the parameters, they are then found by a reconnaissance run of the procedure.
+			virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) { return false; }
+			virtual ReadWriteSet& GetReadWriteSet() { return *recon_rw_set_; }
 		public:
 			size_t type_;
 			char* data_;
+			// read-write set of a reconnoitered transaction that has none of its own.
+			ReadWriteSet* recon_rw_set_;
+			bool is_reconnoitered_;
 		};
 
 		class ParamBatch {
@@ -33,12 +38,14 @@ namespace Cavalia{
 				params_ = new TxnParam*[gParamBatchSize];
 				param_count_ = 0;
 				batch_size_ = gParamBatchSize;
+				cc_type_ = CC_LOCK_WAIT;
 			}
 
 			ParamBatch(const size_t &batch_size) {
 				params_ = new TxnParam*[batch_size];
 				param_count_ = 0;
 				batch_size_ = batch_size;
+				cc_type_ = CC_LOCK_WAIT;
 			}
 
 			~ParamBatch() {
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef __CAVALIA_DATABASE_WATERMARK_H__
+#define __CAVALIA_DATABASE_WATERMARK_H__
+
+#include <boost/thread.hpp>
+#include "../Profiler/VersionGcProfiler.h"
+#include "GlobalTimestamp.h"
+#include "GarbageCollector.h"
+
+// period at which the watermarks of GlobalTimestamp are aggregated, in microseconds.
+#if !defined(WATERMARK_INTERVAL)
+#define WATERMARK_INTERVAL 20
+#endif
+
+namespace Cavalia {
+	namespace Database {
+		/*
+		** Class Watermark:
+		** ----------------
+		** Background thread, started next to Epoch, that folds the per-thread timestamps of GlobalTimestamp
+		** into its minimum and maximum every WATERMARK_INTERVAL microseconds. The multi-version and
+		** snapshot-isolation protocols read these instead of scanning every thread at each transaction.
+		*/
+		class Watermark {
+		public:
+			Watermark() {
+				GlobalTimestamp::RefreshWatermarks();
+				refresh_thread_ = new boost::thread(boost::bind(&Watermark::Start, this));
+			}
+
+			~Watermark() {
+				delete refresh_thread_;
+				refresh_thread_ = NULL;
+			}
+
+		private:
+			void Start() {
+#if !defined(MUTE) && defined(PROFILE_VERSION_GC)
+				size_t sample_countdown = VERSION_GC_SAMPLE_INTERVAL / WATERMARK_INTERVAL;
+#endif
+				while (true) {
+					boost::this_thread::sleep(boost::posix_time::microseconds(WATERMARK_INTERVAL));
+					GlobalTimestamp::RefreshWatermarks();
+#if !defined(MUTE) && defined(PROFILE_VERSION_GC)
+					if (--sample_countdown == 0) {
+						VersionGcStatistics statistics = GarbageCollector::GetStatistics(GlobalTimestamp::thread_count_);
+						SAMPLE_VERSION_GC(statistics);
+						sample_countdown = VERSION_GC_SAMPLE_INTERVAL / WATERMARK_INTERVAL;
+					}
+#endif
+				}
+			}
+
+		private:
+			boost::thread *refresh_thread_;
+		};
+	}
+}
+
+#endif
@@ -17,22 +17,20 @@ namespace Cavalia{
 					virtual ~MicroProcedure(){}
 
 					virtual bool Execute(TxnParam *param, CharArray &ret, const ExeContext &exe_context) {
-						#if defined(DYNAMIC_CC) 
-							context_.cc_type_ = exe_context.cc_type_;
-						#endif
+						context_.PassContext(exe_context);
 						MicroParam* micro_param = static_cast<MicroParam*>(param);
 						for (size_t i = 0; i < NUM_ACCESSES / 2; ++i){
 							SchemaRecord *record = NULL;
 							int64_t key = micro_param->keys_[i];
 							AccessType type = micro_param->rw_set_.CanAvoidConcurrencyControl(key) ? NO_CC_READ_ONLY : READ_ONLY;
-							DB_QUERY(SelectKeyRecord(&context_, MICRO_TABLE_ID, std::string((char*)&key, sizeof(int64_t)), record, type));
+							DB_QUERY(SelectKeyRecord(&context_, MICRO_TABLE_ID, FixedKey(key), record, type));
 							assert(record != NULL);
 						}
 						for (size_t i = NUM_ACCESSES / 2; i < NUM_ACCESSES; ++i){
 							SchemaRecord *record = NULL;
 							int64_t key = micro_param->keys_[i];
 							AccessType type = micro_param->rw_set_.CanAvoidConcurrencyControl(key) ? NO_CC_READ_WRITE : READ_WRITE;
-							DB_QUERY(SelectKeyRecord(&context_, MICRO_TABLE_ID, std::string((char*)&key, sizeof(int64_t)), record, type));
+							DB_QUERY(SelectKeyRecord(&context_, MICRO_TABLE_ID, FixedKey(key), record, type));
 							assert(record != NULL);
 						}
 						return transaction_manager_->CommitTransaction(&context_, param, ret);
@@ -39,7 +39,8 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(keys_), serial_str.char_ptr_, sizeof(int64_t) * NUM_ACCESSES);
 				}
 
-				virtual void BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
 					for (size_t i = 0; i < NUM_ACCESSES / 2; ++i) {
 						BatchAccessInfo* info = batch_rw_set.GetOrAdd(keys_[i]);
 						rw_set_.Add(keys_[i], info);
@@ -52,6 +53,7 @@ namespace Cavalia{
 						info->AddTransaction(this);
 						info->has_writes_ = true;						
 					}
+					return true;
 				}
 
 				virtual ReadWriteSet& GetReadWriteSet() {
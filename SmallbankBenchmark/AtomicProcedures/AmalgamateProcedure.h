@@ -20,15 +20,17 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const AmalgamateParam* amalgamate_param = static_cast<const AmalgamateParam*>(param);
 						SchemaRecord *custid_0_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&amalgamate_param->custid_0_), sizeof(int64_t)), custid_0_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(amalgamate_param->custid_0_), custid_0_record, READ_ONLY));
 						SchemaRecord *custid_1_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&amalgamate_param->custid_1_), sizeof(int64_t)), custid_1_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(amalgamate_param->custid_1_), custid_1_record, READ_ONLY));
 						assert(custid_0_record != NULL);
 						assert(custid_1_record != NULL);
 						SchemaRecord *custid_0_savings_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, std::string((char*)(&amalgamate_param->custid_0_), sizeof(int64_t)), custid_0_savings_record, READ_WRITE));
+						AccessType custid_0_savings_record_type = amalgamate_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(SAVINGS_TABLE_ID, (char*)(&amalgamate_param->custid_0_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, FixedKey(amalgamate_param->custid_0_), custid_0_savings_record, custid_0_savings_record_type));
 						SchemaRecord *custid_0_checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&amalgamate_param->custid_0_), sizeof(int64_t)), custid_0_checking_record, READ_WRITE));
+						AccessType custid_0_checking_record_type = amalgamate_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&amalgamate_param->custid_0_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(amalgamate_param->custid_0_), custid_0_checking_record, custid_0_checking_record_type));
 						assert(custid_0_savings_record != NULL);
 						assert(custid_0_checking_record != NULL);
 						float total = *(float*)(custid_0_savings_record->GetColumn(1)) + *(float*)(custid_0_checking_record->GetColumn(1));
@@ -38,7 +40,8 @@ namespace Cavalia{
 						custid_0_savings_record->UpdateColumn(1, (char*)(&zero));
 
 						SchemaRecord *custid_1_checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&amalgamate_param->custid_1_), sizeof(int64_t)), custid_1_checking_record, READ_WRITE));
+						AccessType custid_1_checking_record_type = amalgamate_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&amalgamate_param->custid_1_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(amalgamate_param->custid_1_), custid_1_checking_record, custid_1_checking_record_type));
 						assert(custid_1_checking_record != NULL);
 						const float checking_amount = *(float*)(custid_1_checking_record->GetColumn(1)) + total;
 						custid_1_checking_record->UpdateColumn(1, (char*)(&checking_amount));
@@ -20,13 +20,15 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const BalanceParam* balance_param = static_cast<const BalanceParam*>(param);
 						SchemaRecord *custid_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&balance_param->custid_), sizeof(int64_t)), custid_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(balance_param->custid_), custid_record, READ_ONLY));
 						assert(custid_record != NULL);
 						SchemaRecord *savings_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, std::string((char*)(&balance_param->custid_), sizeof(int64_t)), savings_record, READ_ONLY));
+						AccessType savings_record_type = balance_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(SAVINGS_TABLE_ID, (char*)(&balance_param->custid_), sizeof(int64_t))) ? NO_CC_READ_ONLY : READ_ONLY;
+						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, FixedKey(balance_param->custid_), savings_record, savings_record_type));
 						assert(savings_record != NULL);
 						SchemaRecord *checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&balance_param->custid_), sizeof(int64_t)), checking_record, READ_ONLY));
+						AccessType checking_record_type = balance_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&balance_param->custid_), sizeof(int64_t))) ? NO_CC_READ_ONLY : READ_ONLY;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(balance_param->custid_), checking_record, checking_record_type));
 						assert(checking_record != NULL);
 						float total = *(float*)(savings_record->GetColumn(1)) + *(float*)(checking_record->GetColumn(1));
 						ret.Memcpy(ret.size_, (char*)(&total), sizeof(float));
@@ -18,10 +18,11 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const DepositCheckingParam * dc_param = static_cast<const DepositCheckingParam*>(param);
 						SchemaRecord *cust_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&dc_param->custid_), sizeof(int64_t)), cust_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(dc_param->custid_), cust_record, READ_ONLY));
 						assert(cust_record != NULL);
 						SchemaRecord *checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&dc_param->custid_), sizeof(int64_t)), checking_record, READ_WRITE));
+						AccessType checking_record_type = dc_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&dc_param->custid_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(dc_param->custid_), checking_record, checking_record_type));
 						assert(checking_record != NULL);
 						float final_amount = *(float*)(checking_record->GetColumn(1)) + dc_param->amount_;
 						checking_record->UpdateColumn(1, (char*)(&final_amount));
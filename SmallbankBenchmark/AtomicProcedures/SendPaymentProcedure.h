@@ -18,16 +18,18 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const SendPaymentParam* sp_param = static_cast<const SendPaymentParam*>(param);
 						SchemaRecord *custid_0_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&sp_param->custid_0_), sizeof(int64_t)), custid_0_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(sp_param->custid_0_), custid_0_record, READ_ONLY));
 						SchemaRecord *custid_1_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&sp_param->custid_1_), sizeof(int64_t)), custid_1_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(sp_param->custid_1_), custid_1_record, READ_ONLY));
 						assert(custid_0_record != NULL);
 						assert(custid_1_record != NULL);
 						SchemaRecord *sendacct_checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&sp_param->custid_0_), sizeof(int64_t)), sendacct_checking_record, READ_WRITE));
+						AccessType sendacct_checking_record_type = sp_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&sp_param->custid_0_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(sp_param->custid_0_), sendacct_checking_record, sendacct_checking_record_type));
 						assert(sendacct_checking_record != NULL);
 						SchemaRecord *destacct_checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&sp_param->custid_1_), sizeof(int64_t)), destacct_checking_record, READ_WRITE));
+						AccessType destacct_checking_record_type = sp_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&sp_param->custid_1_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(sp_param->custid_1_), destacct_checking_record, destacct_checking_record_type));
 						assert(destacct_checking_record != NULL);
 						float sendacct_checking = *(float*)(sendacct_checking_record->GetColumn(1));
 						//if (sp_param->amount_ > sendacct_checking){
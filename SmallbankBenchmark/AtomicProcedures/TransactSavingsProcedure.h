@@ -18,10 +18,11 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const TransactSavingsParam* ts_param = static_cast<const TransactSavingsParam*>(param);
 						SchemaRecord *cust_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&ts_param->custid_), sizeof(int64_t)), cust_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(ts_param->custid_), cust_record, READ_ONLY));
 						assert(cust_record != NULL);
 						SchemaRecord *savings_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, std::string((char*)(&ts_param->custid_), sizeof(int64_t)), savings_record, READ_WRITE));
+						AccessType savings_record_type = ts_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(SAVINGS_TABLE_ID, (char*)(&ts_param->custid_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, FixedKey(ts_param->custid_), savings_record, savings_record_type));
 						assert(savings_record != NULL);
 						float cur_savings = *(float*)(savings_record->GetColumn(1));
 						//if (cur_savings < ts_param->amount_){
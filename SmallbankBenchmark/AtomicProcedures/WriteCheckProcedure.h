@@ -20,12 +20,14 @@ namespace Cavalia{
 						context_.PassContext(exe_context);
 						const WriteCheckParam* wc_param = static_cast<const WriteCheckParam*>(param);
 						SchemaRecord  *cust_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, std::string((char*)(&wc_param->custid_), sizeof(int64_t)), cust_record, READ_ONLY));
+						DB_QUERY(SelectKeyRecord(&context_, ACCOUNTS_TABLE_ID, FixedKey(wc_param->custid_), cust_record, READ_ONLY));
 						assert(cust_record != NULL);
 						SchemaRecord *savings_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, std::string((char*)(&wc_param->custid_), sizeof(int64_t)), savings_record, READ_ONLY));
+						AccessType savings_record_type = wc_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(SAVINGS_TABLE_ID, (char*)(&wc_param->custid_), sizeof(int64_t))) ? NO_CC_READ_ONLY : READ_ONLY;
+						DB_QUERY(SelectKeyRecord(&context_, SAVINGS_TABLE_ID, FixedKey(wc_param->custid_), savings_record, savings_record_type));
 						SchemaRecord *checking_record = NULL;
-						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, std::string((char*)(&wc_param->custid_), sizeof(int64_t)), checking_record, READ_WRITE));
+						AccessType checking_record_type = wc_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(CHECKING_TABLE_ID, (char*)(&wc_param->custid_), sizeof(int64_t))) ? NO_CC_READ_WRITE : READ_WRITE;
+						DB_QUERY(SelectKeyRecord(&context_, CHECKING_TABLE_ID, FixedKey(wc_param->custid_), checking_record, checking_record_type));
 						assert(savings_record != NULL);
 						assert(checking_record != NULL);
 						float balance = *(float*)(savings_record->GetColumn(1)) + *(float*)(checking_record->GetColumn(1));
@@ -5,11 +5,13 @@
 #include <Transaction/TxnParam.h>
 #include "SmallbankRecords.h"
 #include "SmallbankMeta.h"
+#include <Scheduler/AccessInfo.h>
 
 namespace Cavalia{
 	namespace Benchmark{
 		namespace Smallbank{
 			using namespace Cavalia::Database;
+			//accounts are only ever read, they are left out of the read-write sets so that they do not merge clusters.
 			class AmalgamateParam : public TxnParam{
 			public:
 				AmalgamateParam(){
@@ -34,9 +36,22 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&custid_0_), serial_str.char_ptr_, sizeof(int64_t));
 					memcpy(reinterpret_cast<char*>(&custid_1_), serial_str.char_ptr_ + sizeof(int64_t), sizeof(int64_t));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(SAVINGS_TABLE_ID, (char*)(&custid_0_), sizeof(int64_t)), true);
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_0_), sizeof(int64_t)), true);
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_1_), sizeof(int64_t)), true);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_0_;
 				int64_t custid_1_;
+				ReadWriteSet rw_set_;
 			};
 
 			class BalanceParam : public TxnParam{
@@ -60,8 +75,20 @@ namespace Cavalia{
 				virtual void Deserialize(const CharArray& serial_str) {
 					memcpy(reinterpret_cast<char*>(&custid_), serial_str.char_ptr_, sizeof(int64_t));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(SAVINGS_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), false);
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), false);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_;
+				ReadWriteSet rw_set_;
 			};
 
 			class DepositCheckingParam : public TxnParam{
@@ -88,9 +115,20 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&custid_), serial_str.char_ptr_, sizeof(int64_t));
 					memcpy(reinterpret_cast<char*>(&amount_), serial_str.char_ptr_ + sizeof(int64_t), sizeof(float));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), true);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_;
 				float amount_;
+				ReadWriteSet rw_set_;
 			};
 
 			class SendPaymentParam : public TxnParam{
@@ -129,10 +167,22 @@ namespace Cavalia{
 					offset += sizeof(int64_t);
 					memcpy(reinterpret_cast<char*>(&amount_), serial_str.char_ptr_ + offset, sizeof(float));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_0_), sizeof(int64_t)), true);
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_1_), sizeof(int64_t)), true);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_0_; // send account
 				int64_t custid_1_; //dest account
 				float amount_;
+				ReadWriteSet rw_set_;
 			};
 
 			class TransactSavingsParam : public TxnParam{
@@ -165,9 +215,20 @@ namespace Cavalia{
 					offset += sizeof(int64_t);
 					memcpy(reinterpret_cast<char*>(&amount_), serial_str.char_ptr_ + offset, sizeof(float));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(SAVINGS_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), true);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_;
 				float amount_;
+				ReadWriteSet rw_set_;
 			};
 
 			class WriteCheckParam : public TxnParam{
@@ -200,9 +261,21 @@ namespace Cavalia{
 					offset += sizeof(int64_t);
 					memcpy(reinterpret_cast<char*>(&amount_), serial_str.char_ptr_ + offset, sizeof(float));
 				}
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(SAVINGS_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), false);
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CHECKING_TABLE_ID, (char*)(&custid_), sizeof(int64_t)), true);
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int64_t custid_;
 				float amount_;
+				ReadWriteSet rw_set_;
 			};
 		}
 	}
@@ -24,7 +24,8 @@ namespace Cavalia{
 						memcpy(d_key + sizeof(int), &stock_level_param->w_id_, sizeof(int));
 						SchemaRecord *district_record = NULL;
 						// "getOId": "SELECT D_NEXT_O_ID FROM DISTRICT WHERE D_W_ID = ? AND D_ID = ?"
-						DB_QUERY(SelectKeyRecord(&context_, DISTRICT_TABLE_ID, std::string(d_key, sizeof(int)* 2), district_record, READ_ONLY));
+						AccessType district_type = stock_level_param->rw_set_.CanAvoidConcurrencyControl(GetRecordHash(DISTRICT_TABLE_ID, d_key, sizeof(int)* 2)) ? NO_CC_READ_ONLY : READ_ONLY;
+						DB_QUERY(SelectKeyRecord(&context_, DISTRICT_TABLE_ID, FixedKey(d_key, sizeof(int)* 2), district_record, district_type));
 						assert(district_record != NULL);
 						int d_next_o_id = *(int*)(district_record->GetColumn(10));
 						size_t count = 0;
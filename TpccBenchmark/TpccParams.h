@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include <Transaction/TxnParam.h>
+#include <Scheduler/AccessInfo.h>
 #include "TpccInformation.h"
 
 namespace Cavalia{
@@ -40,6 +41,25 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&ol_delivery_d_), serial_str.char_ptr_ + sizeof(int)+sizeof(int), sizeof(int64_t));
 				}
 
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					for (int no_d_id = 1; no_d_id <= DISTRICTS_PER_WAREHOUSE; ++no_d_id){
+						int d_no_key[2] = { no_d_id, w_id_ };
+						rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(DISTRICT_NEW_ORDER_TABLE_ID, (char*)d_no_key, sizeof(d_no_key)), true);
+					}
+					// new orders, orders and customers are found through the district new order records,
+					// a reconnaissance run can follow them.
+				#if defined(RECONNAISSANCE)
+					return false;
+				#else
+					return true;
+				#endif
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int w_id_;
 				int o_carrier_id_;
@@ -48,6 +68,7 @@ namespace Cavalia{
 				int no_o_ids_[DISTRICTS_PER_WAREHOUSE];
 				double sums_[DISTRICTS_PER_WAREHOUSE];
 				int c_ids_[DISTRICTS_PER_WAREHOUSE];
+				ReadWriteSet rw_set_;
 			};
 
 			class NewOrderParam : public TxnParam{
@@ -118,6 +139,26 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(i_qtys_), serial_str.char_ptr_ + offset, sizeof(int)* 15);
 				}
 
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					// items are only ever read, they are left out so that they do not merge clusters.
+					for (size_t i = 0; i < ol_cnt_; ++i){
+						int s_key[2] = { i_ids_[i], i_w_ids_[i] };
+						rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(STOCK_TABLE_ID, (char*)s_key, sizeof(s_key)), true);
+					}
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(WAREHOUSE_TABLE_ID, (char*)(&w_id_), sizeof(int)), false);
+					int d_key[2] = { d_id_, w_id_ };
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(DISTRICT_TABLE_ID, (char*)d_key, sizeof(d_key)), true);
+					int c_key[3] = { c_id_, d_id_, w_id_ };
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CUSTOMER_TABLE_ID, (char*)c_key, sizeof(c_key)), false);
+					// the keys of the inserted rows depend on the next order id of the district.
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int w_id_;
 				int d_id_;
@@ -133,6 +174,7 @@ namespace Cavalia{
 				std::string s_dists_[15];
 				double ol_amounts_[15];
 //#endif
+				ReadWriteSet rw_set_;
 			};
 
 			class PaymentParam : public TxnParam{
@@ -197,6 +239,27 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&h_date_), serial_str.char_ptr_ + offset, sizeof(int64_t));
 				}
 
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(WAREHOUSE_TABLE_ID, (char*)(&w_id_), sizeof(int)), true);
+					int d_key[2] = { d_id_, w_id_ };
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(DISTRICT_TABLE_ID, (char*)d_key, sizeof(d_key)), true);
+					// a customer selected by last name is only known at execution.
+					if (c_id_ != -1){
+						int c_key[3] = { c_id_, d_id_, w_id_ };
+						rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(CUSTOMER_TABLE_ID, (char*)c_key, sizeof(c_key)), true);
+					}
+				#if defined(RECONNAISSANCE)
+					return c_id_ != -1;
+				#else
+					return true;
+				#endif
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int w_id_;
 				int d_id_;
@@ -206,6 +269,7 @@ namespace Cavalia{
 				int c_id_;
 				std::string c_last_;
 				int64_t h_date_;
+				ReadWriteSet rw_set_;
 			};
 
 			class OrderStatusParam : public TxnParam{
@@ -237,11 +301,22 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&c_id_), serial_str.char_ptr_ + sizeof(int)+sizeof(int), sizeof(int));
 				}
 
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					// the order is found through a secondary index, there is no record to declare.
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int w_id_;
 				int d_id_;
 				std::string c_last_;
 				int c_id_;
+				ReadWriteSet rw_set_;
 			};
 
 			class StockLevelParam : public TxnParam{
@@ -270,9 +345,22 @@ namespace Cavalia{
 					memcpy(reinterpret_cast<char*>(&d_id_), serial_str.char_ptr_ + sizeof(int), sizeof(int));
 				}
 
+				virtual bool BuildReadWriteSet(ReadWriteSet& batch_rw_set) {
+					rw_set_.Reset(batch_rw_set.GetArena());
+					int d_key[2] = { d_id_, w_id_ };
+					rw_set_.AddAccess(batch_rw_set, this, GetRecordHash(DISTRICT_TABLE_ID, (char*)d_key, sizeof(d_key)), false);
+					// the order lines to count depend on the next order id of the district.
+					return true;
+				}
+
+				virtual ReadWriteSet& GetReadWriteSet() {
+					return rw_set_;
+				}
+
 			public:
 				int w_id_;
 				int d_id_;
+				ReadWriteSet rw_set_;
 			};
 		}
 	}